@@ -266,11 +266,17 @@ findpkg_finish(TBB_MALLOC_PROXY)
 #parse all the version numbers from tbb
 if(NOT TBB_VERSION)
 
+ #the version moved to oneapi/tbb/version.h with oneTBB
+ set(TBB_VERSION_HEADER "${TBB_INCLUDE_DIR}/tbb/tbb_stddef.h")
+ if(NOT EXISTS "${TBB_VERSION_HEADER}" AND EXISTS "${TBB_INCLUDE_DIR}/oneapi/tbb/version.h")
+   set(TBB_VERSION_HEADER "${TBB_INCLUDE_DIR}/oneapi/tbb/version.h")
+ endif()
+
  #only read the start of the file
  file(READ
-      "${TBB_INCLUDE_DIR}/tbb/tbb_stddef.h"
+      "${TBB_VERSION_HEADER}"
       TBB_VERSION_CONTENTS
-      LIMIT 2048)
+      LIMIT 4096)
 
   string(REGEX REPLACE
     ".*#define TBB_VERSION_MAJOR ([0-9]+).*" "\\1"
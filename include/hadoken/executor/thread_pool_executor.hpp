@@ -37,6 +37,7 @@
 #include <mutex>
 #include <future>
 #include <functional>
+#include <memory>
 
 
 namespace hadoken{
@@ -146,6 +147,11 @@ public:
         _executors[pos]->push(std::move(task));
     }
 
+    /// number of worker threads of the pool
+    std::size_t size() const{
+        return _executors.size();
+    }
+
 
 private:
     std::atomic<std::size_t> _counter;
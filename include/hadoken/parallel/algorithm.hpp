@@ -30,6 +30,11 @@
 #define _HADOKEN_PARALLEL_ALGORITHM_HPP_
 
 #include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <hadoken/parallel/bits/parallel_execution_policy.hpp>
+#include <hadoken/utility/range.hpp>
 
 
 namespace hadoken{
@@ -38,30 +43,38 @@ namespace hadoken{
 namespace parallel{
 
 
-/// sequential execution, no parallelism
-class sequential_execution_policy{};
-
-/// parallel execution allowed
-class parallel_execution_policy{};
-
-/// parallel execution allowed, vector execution allowed
-class parallel_vector_execution_policy{};
-
-
-/// constexpr for sequential execution
-constexpr sequential_execution_policy seq{};
+/// parallel for_each algorithm with execution specifier
+template<typename ExecPolicy, typename Iterator, typename Function>
+inline void for_each(ExecPolicy && policy, Iterator begin_it, Iterator end_it, Function fun);
 
-/// constexpr for parallel execution
-constexpr parallel_execution_policy par{};
+/// parallel for_each_n algorithm
+template<typename ExecPolicy, typename Iterator, typename Size, typename Function>
+inline Iterator for_each_n(ExecPolicy && policy, Iterator first, Size n, Function fun);
 
-/// constexpr for parallel vector execution
-constexpr parallel_vector_execution_policy par_vec{};
+/// parallel for_loop algorithm ( Parallelism TS v2 )
+///
+/// execute fun(i, helpers_values...) for each index i of [start, finish), i can be an integer
+/// or an iterator. rest is a list of reduction and induction helpers followed by the function
+///
+/// \code
+///   double sum = 0;
+///   parallel::for_loop(parallel::par, 0, n, parallel::reduction_plus(sum), [&](int i, double & local_sum){
+///       local_sum += a[idx[i]];
+///   });
+/// \endcode
+///
+/// the iterations are chunked and scheduled like for_range, the chunk results
+/// of the reductions are combined in the order of the iterations
+template<typename ExecPolicy, typename I, typename... Args>
+inline void for_loop(ExecPolicy && policy, I start, I finish, Args && ... rest);
 
+/// parallel for_loop_strided algorithm, iterates on start, start + stride, ... until finish
+template<typename ExecPolicy, typename I, typename S, typename... Args>
+inline void for_loop_strided(ExecPolicy && policy, I start, I finish, S stride, Args && ... rest);
 
-
-/// parallel for_each algorithm with execution specifier
-template<typename ExecPolicy, typename Iterator, typename Function>
-inline void for_each(ExecPolicy && policy, Iterator begin_it, Iterator end_it, Function fun);
+/// parallel for_loop_n algorithm, iterates on [start, start + n)
+template<typename ExecPolicy, typename I, typename Size, typename... Args>
+inline void for_loop_n(ExecPolicy && policy, I start, Size n, Args && ... rest);
 
 /// parallel fill algorithm
 template <typename ExecPolicy, class ForwardIterator, class T>
@@ -81,6 +94,22 @@ OutputIt generate_n( ExecutionPolicy&& policy, OutputIt first, Size count, Gener
 
 
 
+/// Extension: parallel random generation
+///
+/// fill [first, last) with dist(engine) samples: the range is cut in blocks of fixed size,
+/// each block uses its own stream random_engine_derivate(engine, block_id).
+/// The output depends only on the engine state, the distribution and the range size,
+/// it is bit-identical whatever the policy and the number of executors.
+///
+/// engine is advanced of one draw, successive calls generate independent sequences.
+/// Counter based engines ( hadoken::counter_engine ) are recommended: their derivation is cheap.
+/// Distributions with a bulk generate(engine, first, last) ( hadoken::uniform01, hadoken::normal_distribution,
+/// hadoken::exponential_distribution ) fill each block in bulk
+template< class ExecutionPolicy, class ForwardIt, class Engine, class Distribution >
+void generate_random( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Engine & engine, const Distribution & dist );
+
+
+
 /// parallel transform algorithm binary
 template< class ExecutionPolicy, class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation >
 OutputIterator transform( ExecutionPolicy&& policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
@@ -91,6 +120,15 @@ template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryOpera
 OutputIt transform( ExecutionPolicy&& policy, InputIt first1, InputIt last1, OutputIt d_first,
                     UnaryOperation unary_op );
 
+/// Extension: fused transform pipeline
+///
+/// apply the element wise stages op, ops... from left to right
+/// in a single pass over each chunk: *d = opN( ... op2( op1(*it) ) )
+/// without intermediate storage. d_first can be equal to first
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryOperation, class... UnaryOperations >
+OutputIt transform_n( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first,
+                      UnaryOperation op, UnaryOperations... ops );
+
 
 
 /// parallel all_of algorithm
@@ -107,6 +145,122 @@ inline bool none_of( ExecutionPolicy&& policy, InputIterator first, InputIterato
 
 
 
+/// parallel count algorithm
+template< class ExecutionPolicy, class InputIterator, class T >
+typename std::iterator_traits<InputIterator>::difference_type
+    count( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T &value );
+
+/// parallel count_if algorithm
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+typename std::iterator_traits<InputIterator>::difference_type
+    count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
+
+
+
+/// parallel find algorithm
+template< class ExecutionPolicy, class InputIterator, class T >
+inline InputIterator find( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T & value );
+
+/// parallel find_if algorithm
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p );
+
+/// parallel find_first_of algorithm
+template< class ExecutionPolicy, class InputIterator, class ForwardIterator >
+inline InputIterator find_first_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last,
+                                    ForwardIterator s_first, ForwardIterator s_last );
+
+/// parallel find_first_of algorithm with predicate
+template< class ExecutionPolicy, class InputIterator, class ForwardIterator, class BinaryPredicate >
+inline InputIterator find_first_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last,
+                                    ForwardIterator s_first, ForwardIterator s_last, BinaryPredicate p );
+
+
+
+
+/// parallel copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt >
+OutputIt copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first );
+
+/// parallel copy_if algorithm
+///
+/// the copy is stable: the selected elements keep their relative order.
+/// The compaction algorithms ( copy_if, remove_if, partition, unique, ... ) count the
+/// selected elements by blocks, scan the counts and scatter each block to its final position
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+OutputIt copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p );
+
+/// parallel remove_copy_if algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+OutputIt remove_copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p );
+
+/// parallel remove_if algorithm
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+ForwardIt remove_if( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p );
+
+/// parallel partition_copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt1, class OutputIt2, class UnaryPredicate >
+std::pair<OutputIt1, OutputIt2> partition_copy( ExecutionPolicy&& policy, InputIt first, InputIt last,
+                                                OutputIt1 d_first_true, OutputIt2 d_first_false, UnaryPredicate p );
+
+/// parallel partition algorithm
+///
+/// unlike std::partition, the partition is stable for every policy
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+ForwardIt partition( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p );
+
+/// parallel unique_copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt >
+OutputIt unique_copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first );
+
+/// parallel unique_copy algorithm with predicate
+template< class ExecutionPolicy, class InputIt, class OutputIt, class BinaryPredicate >
+OutputIt unique_copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, BinaryPredicate p );
+
+/// parallel unique algorithm
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel unique algorithm with predicate
+template< class ExecutionPolicy, class ForwardIt, class BinaryPredicate >
+ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, BinaryPredicate p );
+
+
+
+
+/// parallel min_element algorithm
+///
+/// with equivalent elements, the first one is returned
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel min_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+/// parallel max_element algorithm
+///
+/// with equivalent elements, the first one is returned
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel max_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+/// parallel minmax_element algorithm
+///
+/// same result as std::minmax_element: the first smallest
+/// and the last largest element
+template< class ExecutionPolicy, class ForwardIt >
+std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last );
+
+/// parallel minmax_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp );
+
+
+
 
 /// sort algorithm
 template< class ExecutionPolicy, class RandomIt >
@@ -116,6 +270,77 @@ void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last );
 template< class ExecutionPolicy, class RandomIt, class Compare >
 void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last, Compare comp );
 
+/// nth_element algorithm
+///
+/// parallel three way partitions around sampled pivots, until the
+/// range containing nth is small enough for std::nth_element
+template< class ExecutionPolicy, class RandomIt >
+void nth_element( ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last );
+
+/// nth_element algorithm with comparator
+template< class ExecutionPolicy, class RandomIt, class Compare >
+void nth_element( ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last, Compare comp );
+
+/// partial_sort algorithm
+template< class ExecutionPolicy, class RandomIt >
+void partial_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last );
+
+/// partial_sort algorithm with comparator
+template< class ExecutionPolicy, class RandomIt, class Compare >
+void partial_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last, Compare comp );
+
+
+
+///
+/// sorted ranges
+///
+/// the set algorithms split their inputs along the merge path of the two ranges,
+/// the splits are snapped on the runs of equivalent elements to keep the std semantic on multisets.
+/// The parallel version requires random access input ranges
+
+/// set_intersection algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_intersection( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                           InputIt2 first2, InputIt2 last2, OutputIt d_first );
+
+/// set_intersection algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_intersection( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                           InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp );
+
+/// set_union algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_union( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                    InputIt2 first2, InputIt2 last2, OutputIt d_first );
+
+/// set_union algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_union( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                    InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp );
+
+/// set_difference algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_difference( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                         InputIt2 first2, InputIt2 last2, OutputIt d_first );
+
+/// set_difference algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_difference( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                         InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp );
+
+/// Extension: batched lower_bound
+///
+/// write in d_first the lower_bound in [first, last) of each of the n_queries sorted queries of q_first,
+/// in one merge walk: the cost is linear in the number of queries and logarithmic in the gaps between results
+template< class ExecutionPolicy, class ForwardIt, class InputIt, class Size, class OutputIt >
+OutputIt lower_bound_n( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        InputIt q_first, Size n_queries, OutputIt d_first );
+
+/// Extension: batched lower_bound with comparator
+template< class ExecutionPolicy, class ForwardIt, class InputIt, class Size, class OutputIt, class Compare >
+OutputIt lower_bound_n( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        InputIt q_first, Size n_queries, OutputIt d_first, Compare comp );
+
 
 
 ///
@@ -132,15 +357,94 @@ OutputIt inclusive_scan( ExecutionPolicy&& policy,
                          InputIt first, InputIt last, OutputIt d_first,
                          BinaryOperation binary_op);
                          
+/// reduce algorithm
+///
+/// binary_op is required to be associative and commutative, with par_vec
+/// the partial sums of arithmetic types are computed with vector instructions
+///
+/// the chunk results are combined in a fixed tree order: with par_deterministic,
+/// floating point results are identical whatever the number of executors
+template< class ExecutionPolicy, class InputIt >
+typename std::iterator_traits<InputIt>::value_type reduce( ExecutionPolicy&& policy, InputIt first, InputIt last);
+
+/// reduce algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class T >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init);
+
+/// reduce algorithm with initial value and binary operation
+template< class ExecutionPolicy, class InputIt, class T, class BinaryOperation >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init, BinaryOperation binary_op);
+
+
+/// Extension: histogram algorithm
+///
+/// for each element v of [first, last), increment bins_first[keyfn(v)],
+/// keyfn has to return an index in [0, bins_last - bins_first).
+/// The counts are added to the current content of the bins.
+///
+/// each executor accumulates in a private histogram, merged at the end; for large numbers of bins
+/// the keys are first partitioned by ranges of bins, each range being updated by a single task
+template< class ExecutionPolicy, class InputIt, class RandomIt, class KeyFunction >
+void histogram( ExecutionPolicy&& policy, InputIt first, InputIt last, RandomIt bins_first, RandomIt bins_last, KeyFunction keyfn );
+
+/// Extension: weighted histogram algorithm
+///
+/// same as histogram, bins_first[keyfn(v)] is incremented by weightfn(v)
+template< class ExecutionPolicy, class InputIt, class RandomIt, class KeyFunction, class WeightFunction >
+void histogram( ExecutionPolicy&& policy, InputIt first, InputIt last, RandomIt bins_first, RandomIt bins_last,
+                KeyFunction keyfn, WeightFunction weightfn );
+
+/// Extension: reduce_by_key algorithm
+///
+/// for each run of consecutive equal keys of [keys_first, keys_last), write the key in keys_out
+/// and the sum of the corresponding values of values_first in values_out.
+/// Return the end of the two outputs
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt1, class OutputIt2 >
+std::pair<OutputIt1, OutputIt2> reduce_by_key( ExecutionPolicy&& policy, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                               OutputIt1 keys_out, OutputIt2 values_out );
+
+/// Extension: reduce_by_key algorithm with key predicate and binary operation
+///
+/// consecutive keys k1, k2 belong to the same run if pred(k1, k2), the values are reduced with op
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt1, class OutputIt2,
+          class BinaryPredicate, class BinaryOperation >
+std::pair<OutputIt1, OutputIt2> reduce_by_key( ExecutionPolicy&& policy, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                               OutputIt1 keys_out, OutputIt2 values_out,
+                                               BinaryPredicate pred, BinaryOperation op );
+                         
                          
 
 /// Extension: for_range_ algorithm
 ///
 /// for_range is an extension to for_each where the function
 /// execute on a subrange, instead of a single element
+///
+/// the range is cut in chunks following the options of the policy
+/// ( see parallel::grain, parallel::chunks, parallel::dynamic, parallel::guided,
+///   parallel::sequential_threshold ), fun can be called several times by the same executor
 template<typename ExecPolicy, typename Iterator, typename RangeFunction>
 inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun);
 
+
+/// Extension: for_range algorithm over the tiles of a 2D range
+///
+/// fun(tile) is called for each tile of the blocked_range2d range,
+/// the tiles are distributed following the options of the policy
+template<typename ExecPolicy, typename RowValue, typename ColValue, typename TileFunction>
+inline void for_range(ExecPolicy && policy, const blocked_range2d<RowValue, ColValue> & range, TileFunction fun);
+
+
+/// Extension: for_range_fused algorithm
+///
+/// execute successively each range function of funs on the whole range,
+/// each function sees the complete result of the previous ones.
+///
+/// All the stages share a single parallel region when the backend supports it,
+/// which avoids to pay the startup of a parallel region for each call of a chain
+/// of small algorithms
+template<typename ExecPolicy, typename Iterator, typename... RangeFunctions>
+inline void for_range_fused(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunctions... funs);
+
 } // parallel
 
 
@@ -148,7 +452,41 @@ inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it,
 } // hadoken
 
 
+///
+/// backend selection, at compile time
+///
+/// HADOKEN_PARALLEL_USE_OMP     : OpenMP ( default when compiled with OpenMP support )
+/// HADOKEN_PARALLEL_USE_THREAD  : hadoken executors on native C++11 threads ( default otherwise )
+/// HADOKEN_PARALLEL_USE_TBB     : Intel TBB task scheduler
+/// HADOKEN_PARALLEL_USE_PSTL    : C++17 standard parallel algorithms ( std::execution )
+///
+/// a policy bound to an executor with par.on(executor) runs on this executor
+/// whatever the selected backend
+///
+#if ((defined HADOKEN_PARALLEL_USE_OMP) + (defined HADOKEN_PARALLEL_USE_THREAD) \
+    + (defined HADOKEN_PARALLEL_USE_TBB) + (defined HADOKEN_PARALLEL_USE_PSTL)) > 1
+#error "only one of HADOKEN_PARALLEL_USE_OMP, HADOKEN_PARALLEL_USE_THREAD, HADOKEN_PARALLEL_USE_TBB, HADOKEN_PARALLEL_USE_PSTL can be defined"
+#endif
+
+#if !(defined HADOKEN_PARALLEL_USE_OMP) && !(defined HADOKEN_PARALLEL_USE_THREAD) \
+    && !(defined HADOKEN_PARALLEL_USE_TBB) && !(defined HADOKEN_PARALLEL_USE_PSTL)
+#if (defined _OPENMP) || (defined CPP17_ALGORITHM_FORCE_SEQ)
+#define HADOKEN_PARALLEL_USE_OMP
+#else
+#define HADOKEN_PARALLEL_USE_THREAD
+#endif
+#endif
+
+
+#if (defined HADOKEN_PARALLEL_USE_TBB)
+#include <hadoken/parallel/bits/tbb_algorithm_impl.hpp>
+#elif (defined HADOKEN_PARALLEL_USE_PSTL)
+#include <hadoken/parallel/bits/pstl_algorithm_impl.hpp>
+#elif (defined HADOKEN_PARALLEL_USE_THREAD)
+#include <hadoken/parallel/bits/cxx11_thread_algorithm_impl.hpp>
+#else
 #include <hadoken/parallel/bits/omp_algorithm_impl.hpp>
+#endif
 
 
 
@@ -39,14 +39,22 @@
 #include <hadoken/parallel/algorithm.hpp>
 #include <hadoken/utility/range.hpp>
 #include <hadoken/executor/system_executor.hpp>
-#include <hadoken/thread/latch.hpp>
+#include <hadoken/parallel/bits/parallel_executor_generic.hpp>
 
 
 #include <hadoken/parallel/bits/parallel_algorithm_generics.hpp>
+#include <hadoken/parallel/bits/parallel_for_loop_generic.hpp>
 #include <hadoken/parallel/bits/parallel_none_any_all_generic.hpp>
+#include <hadoken/parallel/bits/parallel_find_generic.hpp>
+#include <hadoken/parallel/bits/parallel_count_generics.hpp>
 #include <hadoken/parallel/bits/parallel_transform_generic.hpp>
 #include <hadoken/parallel/bits/parallel_sort_generic.hpp>
 #include <hadoken/parallel/bits/parallel_numeric_generic.hpp>
+#include <hadoken/parallel/bits/parallel_copy_generic.hpp>
+#include <hadoken/parallel/bits/parallel_minmax_generic.hpp>
+#include <hadoken/parallel/bits/parallel_random_generic.hpp>
+#include <hadoken/parallel/bits/parallel_set_generic.hpp>
+#include <hadoken/parallel/bits/parallel_histogram_generic.hpp>
 
 namespace hadoken{
 
@@ -63,38 +71,41 @@ class parallel_vector_execution_policy;
 namespace detail{
 
 
-std::size_t get_parallel_task(){
+inline std::size_t get_parallel_task(){
     return std::thread::hardware_concurrency();
 }
 
 
-/// for_range algorithm
-template<typename Iterator, typename RangeFunction>
-inline void _simple_cxx11_for_range(Iterator begin_it, Iterator end_it, RangeFunction fun){
-    const std::size_t n_task = get_parallel_task();
-
-    thread::latch latch_task(n_task);
-
-    range<Iterator> global_range(begin_it, end_it);
-
+/// for_range algorithm on the system executor
+template<typename ExecPolicy, typename Iterator, typename RangeFunction>
+inline void _simple_cxx11_for_range(const ExecPolicy & policy, Iterator begin_it, Iterator end_it, RangeFunction & fun){
     system_executor sexec;
+    _executor_for_range(get_execution_parameters(policy), sexec, begin_it, end_it, fun);
+}
 
-    // start task for tasks 1-N on separated executors
-    for(std::size_t i = 1; i < n_task; ++i){
+/// for_range algorithm on the executor bound to the policy
+template<typename Policy, typename Executor, typename Iterator, typename RangeFunction>
+inline void _simple_cxx11_for_range(const executor_execution_policy<Policy, Executor> & policy, Iterator begin_it, Iterator end_it, RangeFunction & fun){
+    _executor_for_range(policy, begin_it, end_it, fun);
+}
 
-         sexec.execute([i, &latch_task, &global_range, &n_task, &fun](){
-            auto my_range = take_splice(global_range, i, n_task);
-            fun(my_range.begin(), my_range.end());
-            latch_task.count_down(1);
-        });
-    }
 
-    // execute the task 0 locally
-    auto my_range = take_splice(global_range, 0, n_task);
-    fun(my_range.begin(), my_range.end());
+template<typename ExecPolicy, typename Iterator>
+inline void _cxx11_for_range_stages(const ExecPolicy & policy, Iterator begin_it, Iterator end_it){
+    (void) policy;
+    (void) begin_it;
+    (void) end_it;
+}
 
-    // wait for the folks
-    latch_task.count_down_and_wait(1);
+template<typename ExecPolicy, typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void _cxx11_for_range_stages(const ExecPolicy & policy, Iterator begin_it, Iterator end_it,
+                                    RangeFunction & fun, RangeFunctions & ... funs){
+    if(is_parallel_policy(policy)){
+        _simple_cxx11_for_range(policy, begin_it, end_it, fun);
+    }else{
+        fun(begin_it, end_it);
+    }
+    _cxx11_for_range_stages(policy, begin_it, end_it, funs...);
 }
 
 
@@ -106,7 +117,7 @@ inline void _simple_cxx11_for_range(Iterator begin_it, Iterator end_it, RangeFun
 template<typename ExecPolicy, typename Iterator, typename RangeFunction>
 inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
     if(detail::is_parallel_policy(policy)){
-        detail::_simple_cxx11_for_range(begin_it, end_it, fun);
+        detail::_simple_cxx11_for_range(policy, begin_it, end_it, fun);
         return;
     }
 
@@ -114,6 +125,13 @@ inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it,
 }
 
 
+/// for_range_fused algorithm
+template<typename ExecPolicy, typename Iterator, typename... RangeFunctions>
+inline void for_range_fused(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunctions... funs){
+    detail::_cxx11_for_range_stages(policy, begin_it, end_it, funs...);
+}
+
+
 
 
 } // concurrent
@@ -33,6 +33,7 @@
 #include <iterator>
 #include <stdexcept>
 #include <cstdint>
+#include <thread>
 
 #if !(defined _OPENMP) || (defined CPP17_ALGORITHM_FORCE_SEQ)
 #warning "No OpenMP support available: parallel algorithm execution disabled"
@@ -45,12 +46,21 @@
 
 #include <hadoken/parallel/algorithm.hpp>
 #include <hadoken/utility/range.hpp>
+#include <hadoken/parallel/bits/parallel_executor_generic.hpp>
 
 #include <hadoken/parallel/bits/parallel_algorithm_generics.hpp>
+#include <hadoken/parallel/bits/parallel_for_loop_generic.hpp>
 #include <hadoken/parallel/bits/parallel_none_any_all_generic.hpp>
+#include <hadoken/parallel/bits/parallel_find_generic.hpp>
+#include <hadoken/parallel/bits/parallel_count_generics.hpp>
 #include <hadoken/parallel/bits/parallel_transform_generic.hpp>
 #include <hadoken/parallel/bits/parallel_sort_generic.hpp>
 #include <hadoken/parallel/bits/parallel_numeric_generic.hpp>
+#include <hadoken/parallel/bits/parallel_copy_generic.hpp>
+#include <hadoken/parallel/bits/parallel_minmax_generic.hpp>
+#include <hadoken/parallel/bits/parallel_random_generic.hpp>
+#include <hadoken/parallel/bits/parallel_set_generic.hpp>
+#include <hadoken/parallel/bits/parallel_histogram_generic.hpp>
 
 
 namespace hadoken{
@@ -69,116 +79,173 @@ namespace detail{
 
 inline int __get_number_executor(){
 #ifndef __ALGORITHM_NO_OPENMP
-    // TODO : should be configurable parameter, extracted from execution_policy
-    return std::thread::hardware_concurrency();
+    // called from an active parallel region: the team is already busy,
+    // the call is executed by the calling thread without opening a nested region
+    if(omp_in_parallel()){
+        return 1;
+    }
+    // follow the OpenMP runtime configuration ( OMP_NUM_THREADS, omp_set_num_threads )
+    return omp_get_max_threads();
 #else
     return 1;
 #endif
 }
 
-template<typename Function>
-inline void __execute_grid(int num_executor, Function fun){
+
 #ifndef __ALGORITHM_NO_OPENMP
-    //std::cout << "val " << num_executor << std::endl;
-    #pragma omp parallel
-    {
 
-       #pragma omp single
-       {
+// worksharing loop over the chunks of the scheduler
+// need to be encountered by every thread of the current team
+template<typename Iterator, typename RangeFunction>
+inline void __omp_for_chunks(const chunk_scheduler & scheduler, schedule_type sched, Iterator begin_it, RangeFunction & fun){
+    const long n_chunks = static_cast<long>(scheduler.size());
+
+    if(sched == schedule_type::static_schedule || sched == schedule_type::deterministic_schedule){
+        #pragma omp for schedule(static)
+        for(long chunk_id = 0; chunk_id < n_chunks; ++chunk_id){
+            std::size_t chunk_first, chunk_last;
+            scheduler.chunk(chunk_id, chunk_first, chunk_last);
+            fun(get_end_iterator(begin_it, chunk_first), get_end_iterator(begin_it, chunk_last));
+        }
+    }else{
+        #pragma omp for schedule(dynamic, 1)
+        for(long chunk_id = 0; chunk_id < n_chunks; ++chunk_id){
+            std::size_t chunk_first, chunk_last;
+            scheduler.chunk(chunk_id, chunk_first, chunk_last);
+            fun(get_end_iterator(begin_it, chunk_first), get_end_iterator(begin_it, chunk_last));
+        }
+    }
+}
 
-           for(int id = 0; id < num_executor; ++id){
 
-               #pragma omp task firstprivate(id)
-               {
-                fun(id, num_executor);
-               }
-            }
+template<typename Iterator>
+inline void __omp_for_chunks_stages(const chunk_scheduler & scheduler, schedule_type sched, Iterator begin_it){
+    (void) scheduler;
+    (void) sched;
+    (void) begin_it;
+}
 
-        }
+// one worksharing loop per stage, the implicit barrier
+// of each loop separates the stages
+template<typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void __omp_for_chunks_stages(const chunk_scheduler & scheduler, schedule_type sched, Iterator begin_it,
+                                    RangeFunction & fun, RangeFunctions & ... funs){
+    __omp_for_chunks(scheduler, sched, begin_it, fun);
+    __omp_for_chunks_stages(scheduler, sched, begin_it, funs...);
+}
 
-    }
-#else
-    for(int id =0 ; id < num_executor; ++id){
-        fun(id, num_executor);
-    }
 #endif
+
+
+template<typename Iterator>
+inline void __run_stages_sequential(Iterator begin_it, Iterator end_it){
+    (void) begin_it;
+    (void) end_it;
 }
 
-/// for_each algorithm
-template<typename Iterator, typename Function>
-inline void _omp_parallel_for_range(Iterator begin_it, Iterator end_it, Function fun){
-    range<Iterator> global_range(begin_it, end_it);
+template<typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void __run_stages_sequential(Iterator begin_it, Iterator end_it, RangeFunction & fun, RangeFunctions & ... funs){
+    fun(begin_it, end_it);
+    __run_stages_sequential(begin_it, end_it, funs...);
+}
 
-    const int num_exec = __get_number_executor();
 
-    __execute_grid(num_exec, [&](int id, int num_executor){
-                range<Iterator> my_range = take_splice(global_range, id, num_executor);
-                fun(my_range.begin(), my_range.end());
-    });
+template<typename Iterator>
+inline void __run_chunks_stages_sequential(const chunk_scheduler & scheduler, Iterator begin_it){
+    (void) scheduler;
+    (void) begin_it;
 }
 
-} // detail
+template<typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void __run_chunks_stages_sequential(const chunk_scheduler & scheduler, Iterator begin_it,
+                                           RangeFunction & fun, RangeFunctions & ... funs){
+    for(std::size_t chunk_id = 0; chunk_id < scheduler.size(); ++chunk_id){
+        std::size_t chunk_first, chunk_last;
+        scheduler.chunk(chunk_id, chunk_first, chunk_last);
+        fun(get_end_iterator(begin_it, chunk_first), get_end_iterator(begin_it, chunk_last));
+    }
+    __run_chunks_stages_sequential(scheduler, begin_it, funs...);
+}
 
 
+/// for_range algorithm, with one or several successive stages
+/// executed in a single parallel region
+template<typename ExecPolicy, typename Iterator, typename... RangeFunctions>
+inline void _omp_parallel_for_range(const ExecPolicy & policy, Iterator begin_it, Iterator end_it, RangeFunctions & ... funs){
+    const execution_parameters params = get_execution_parameters(policy);
+    const std::size_t n_elems = std::distance(begin_it, end_it);
 
-/// for_each algorithm
-template<typename ExecPolicy, typename Iterator, typename RangeFunction>
-inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
-    if( detail::is_parallel_policy(policy) ){
-        detail::_omp_parallel_for_range(begin_it, end_it, fun);
+    // the chunk functions are never called on an empty range
+    if(n_elems == 0){
         return;
     }
 
-   fun(begin_it, end_it);
-}
+    if(n_elems < params.threshold()){
+        __run_stages_sequential(begin_it, end_it, funs...);
+        return;
+    }
 
-/// parallel count_if algorithm
-template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
-typename std::iterator_traits<InputIterator>::difference_type
-    count_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    const chunk_scheduler scheduler(n_elems, __get_number_executor(), params, make_range_alignment(begin_it, n_elems));
+    const int n_workers = static_cast<int>(scheduler.concurrency());
 
-    typedef typename std::iterator_traits<InputIterator>::difference_type counter_type;
+#ifndef __ALGORITHM_NO_OPENMP
+    if(n_workers > 1){
+        #pragma omp parallel num_threads(n_workers)
+        {
+            __omp_for_chunks_stages(scheduler, params.schedule(), begin_it, funs...);
+        }
+        return;
+    }
+#else
+    (void) n_workers;
+#endif
 
-    static_assert(std::is_same< typename std::iterator_traits<InputIterator>::iterator_category, std::random_access_iterator_tag>::value , "parallel::count requires random_access_iterator");
+    // single executor: execute the chunks in the calling thread
+    // no worksharing construct here, the caller can be a thread of an enclosing team
+    __run_chunks_stages_sequential(scheduler, begin_it, funs...);
+}
 
-    if( detail::is_parallel_policy(policy) ){
 
-        const std::size_t nelems = std::distance(first, last);
-        std::atomic<uint64_t> counter(0);
+template<typename Policy, typename Executor, typename Iterator>
+inline void _omp_parallel_for_range(const executor_execution_policy<Policy, Executor> & policy, Iterator begin_it, Iterator end_it){
+    (void) policy;
+    (void) begin_it;
+    (void) end_it;
+}
 
-        const int number_executor = detail::__get_number_executor();
+/// for_range algorithm on the executor bound to the policy
+template<typename Policy, typename Executor, typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void _omp_parallel_for_range(const executor_execution_policy<Policy, Executor> & policy, Iterator begin_it, Iterator end_it,
+                                    RangeFunction & fun, RangeFunctions & ... funs){
+    _executor_for_range(policy, begin_it, end_it, fun);
+    _omp_parallel_for_range(policy, begin_it, end_it, funs...);
+}
 
-        detail::__execute_grid(number_executor, [&](int id, int number_executor){
-           std::size_t nelem_per_slice = nelems / number_executor;
+} // detail
 
-           InputIterator my_begin = first + (id * nelem_per_slice);
-           InputIterator my_end = ( ((id +1) == number_executor) ? (last): (my_begin + nelem_per_slice));
 
-           counter += std::count_if(my_begin, my_end, p);
-        });
 
-        return counter_type(counter.load());
-    }else{
-        return std::count_if(first, last, p);
+/// for_range algorithm
+template<typename ExecPolicy, typename Iterator, typename RangeFunction>
+inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
+    if( detail::is_parallel_policy(policy) ){
+        detail::_omp_parallel_for_range(policy, begin_it, end_it, fun);
+        return;
     }
-}
-
-/// parallel count algorithm
-template< class ExecutionPolicy, class InputIterator, class T >
-typename std::iterator_traits<InputIterator>::difference_type
-    count( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T &value ){
-    using value_type = typename std::iterator_traits<InputIterator>::value_type;
-
-    return count_if(std::move(policy),
-                    first, last,
-                    [&value](const value_type & v){
-                        return (v == static_cast<value_type>(value));
-                    }
-    );
 
+   fun(begin_it, end_it);
 }
 
+/// for_range_fused algorithm
+template<typename ExecPolicy, typename Iterator, typename... RangeFunctions>
+inline void for_range_fused(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunctions... funs){
+    if( detail::is_parallel_policy(policy) ){
+        detail::_omp_parallel_for_range(policy, begin_it, end_it, funs...);
+        return;
+    }
 
+    detail::__run_stages_sequential(begin_it, end_it, funs...);
+}
 
 
 
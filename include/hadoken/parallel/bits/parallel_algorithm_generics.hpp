@@ -34,6 +34,7 @@
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_vector_generic.hpp"
 
 
 namespace hadoken{
@@ -56,14 +57,17 @@ inline void for_each(ExecPolicy && policy, Iterator begin_it, Iterator end_it, F
 }
 
 
-// reimplement fill using for_each
+// parallel fill algorithm
 template <typename ExecutionPolicy, class ForwardIterator, class T>
 void fill(ExecutionPolicy && policy, ForwardIterator first, ForwardIterator last, const T& val){
-    using value_type = typename std::iterator_traits<ForwardIterator>::value_type;
+    if(detail::is_parallel_policy(policy)){
+        ::hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&val](ForwardIterator sub_begin, ForwardIterator sub_end){
+            detail::_chunk_fill(detail::use_simd_path<ExecutionPolicy, ForwardIterator>(), sub_begin, sub_end, val);
+        });
+        return;
+    }
 
-    ::hadoken::parallel::for_each(std::forward<ExecutionPolicy>(policy), first, last, [&val](value_type& elem){
-        elem = val;
-    });
+    std::fill(first, last, val);
 }
 
 
@@ -0,0 +1,532 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_COPY_GENERIC_HPP
+#define PARALLEL_COPY_GENERIC_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <hadoken/parallel/algorithm.hpp>
+
+
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+template<typename Iterator>
+struct is_forward_iterator : public std::is_base_of<std::forward_iterator_tag,
+                                                    typename std::iterator_traits<Iterator>::iterator_category>{};
+
+/// true if all the iterators are forward iterators, selects the multi pass parallel versions at compile time
+template<typename... Iterators>
+struct are_forward_iterators : public std::true_type{};
+
+template<typename Iterator, typename... Iterators>
+struct are_forward_iterators<Iterator, Iterators...> : public std::integral_constant<bool,
+        is_forward_iterator<Iterator>::value && are_forward_iterators<Iterators...>::value>{};
+
+/// true if the in place algorithms can relocate the elements through a temporary buffer
+template<typename ForwardIt>
+struct is_relocatable_iterator : public std::integral_constant<bool,
+        is_forward_iterator<ForwardIt>::value
+        && std::is_nothrow_move_constructible<typename std::iterator_traits<ForwardIt>::value_type>::value>{};
+
+
+typedef boost::counting_iterator<std::size_t> block_id_iterator;
+
+// policy used to distribute the blocks of a block_decomposition,
+// the grain and the threshold are already consumed by the decomposition
+inline sequential_execution_policy _block_policy(const sequential_execution_policy & policy){
+    return policy;
+}
+
+template<typename Policy>
+inline Policy _block_policy(const execution_policy_base<Policy> & policy){
+    return policy.with(grain(0), sequential_threshold(0));
+}
+
+
+// execute fun(block_id) for each block of the decomposition
+template<typename ExecutionPolicy, typename BlockFunction>
+inline void _for_each_block(const ExecutionPolicy & policy, const block_decomposition & blocks, BlockFunction fun){
+    ::hadoken::parallel::for_range(_block_policy(policy), block_id_iterator(0), block_id_iterator(blocks.size()),
+                                   [&fun](block_id_iterator b_first, block_id_iterator b_last){
+        for(; b_first != b_last; ++b_first){
+            fun(*b_first);
+        }
+    });
+}
+
+
+// flag the elements of [pos, pos_last) for which p is true, return the number of flagged elements
+template<typename Iterator, typename UnaryPredicate>
+inline std::size_t _flag_if(Iterator first, std::size_t pos, std::size_t pos_last,
+                            unsigned char* flags, UnaryPredicate & p){
+    std::size_t n_flagged = 0;
+    for(Iterator it = get_end_iterator(first, pos); pos < pos_last; ++pos, ++it){
+        const bool selected = p(*it);
+        flags[pos] = selected;
+        n_flagged += (selected ? 1 : 0);
+    }
+    return n_flagged;
+}
+
+// flag the elements of [pos, pos_last) which are not equivalent to their predecessor
+template<typename Iterator, typename BinaryPredicate>
+inline std::size_t _flag_unique(Iterator first, std::size_t pos, std::size_t pos_last,
+                                unsigned char* flags, BinaryPredicate & p){
+    std::size_t n_flagged = 0;
+    if(pos == 0 && pos < pos_last){
+        flags[pos++] = true;
+        n_flagged += 1;
+    }
+
+    Iterator prev = get_end_iterator(first, pos - 1);
+    for(Iterator it = std::next(prev); pos < pos_last; ++pos, ++prev, ++it){
+        const bool selected = !p(*prev, *it);
+        flags[pos] = selected;
+        n_flagged += (selected ? 1 : 0);
+    }
+    return n_flagged;
+}
+
+
+///
+/// first passes of the stable compaction:
+/// flag_block(block_id, flags) flags the selected elements of a block and returns their number,
+/// the counts are then scanned
+///
+/// offsets[b] is the number of selected elements before the block b
+/// and offsets[blocks.size()] the total number of selected elements
+///
+template<typename ExecutionPolicy, typename BlockFlagFunction>
+inline std::vector<std::size_t> _flag_blocks(const ExecutionPolicy & policy, const block_decomposition & blocks,
+                                             std::vector<unsigned char> & flags, BlockFlagFunction flag_block){
+    std::vector<std::size_t> offsets(blocks.size() + 1, 0);
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        offsets[block_id + 1] = flag_block(block_id, flags.data());
+    });
+
+    ::hadoken::parallel::inclusive_scan(_block_policy(policy), offsets.begin() + 1, offsets.end(), offsets.begin() + 1);
+    return offsets;
+}
+
+
+///
+/// last pass of the stable compaction: assign(out, it) the flagged elements
+/// of each block to d_selected + offsets[block]. The other elements are assigned to
+/// d_rejected + ( number of rejected elements before them ) if with_rejected is true
+///
+template<typename ExecutionPolicy, typename Iterator, typename OutputIt1, typename OutputIt2, typename Assign>
+inline void _scatter_blocks(const ExecutionPolicy & policy, const block_decomposition & blocks,
+                            const std::vector<unsigned char> & flags, const std::vector<std::size_t> & offsets,
+                            Iterator first, OutputIt1 d_selected, OutputIt2 d_rejected, bool with_rejected, Assign assign){
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        const std::size_t pos_first = blocks.block_first(block_id), pos_last = blocks.block_last(block_id);
+
+        Iterator it = get_end_iterator(first, pos_first);
+        OutputIt1 out_selected = get_end_iterator(d_selected, offsets[block_id]);
+
+        if(with_rejected == false){
+            for(std::size_t pos = pos_first; pos < pos_last; ++pos, ++it){
+                if(flags[pos]){
+                    assign(out_selected, it);
+                    ++out_selected;
+                }
+            }
+            return;
+        }
+
+        OutputIt2 out_rejected = get_end_iterator(d_rejected, pos_first - offsets[block_id]);
+        for(std::size_t pos = pos_first; pos < pos_last; ++pos, ++it){
+            if(flags[pos]){
+                assign(out_selected, it);
+                ++out_selected;
+            }else{
+                assign(out_rejected, it);
+                ++out_rejected;
+            }
+        }
+    });
+}
+
+
+struct copy_assign{
+    template<typename OutputIt, typename InputIt>
+    inline void operator()(OutputIt & out, InputIt & in) const{
+        *out = *in;
+    }
+};
+
+struct move_assign{
+    template<typename OutputIt, typename InputIt>
+    inline void operator()(OutputIt & out, InputIt & in) const{
+        *out = std::move(*in);
+    }
+};
+
+struct move_construct{
+    template<typename T, typename InputIt>
+    inline void operator()(T* & out, InputIt & in) const{
+        ::new (static_cast<void*>(out)) T(std::move(*in));
+    }
+};
+
+
+/// temporary storage of the in place algorithms, without default construction of its elements:
+/// all of them must be constructed ( move_construct ) before its destruction
+template<typename T>
+class _relocation_buffer{
+public:
+    inline explicit _relocation_buffer(std::size_t n) : _data(std::allocator<T>().allocate(n)), _size(n){}
+
+    inline ~_relocation_buffer(){
+        for(std::size_t i = 0; i < _size; ++i){
+            _data[i].~T();
+        }
+        std::allocator<T>().deallocate(_data, _size);
+    }
+
+    _relocation_buffer(const _relocation_buffer &) = delete;
+    _relocation_buffer & operator=(const _relocation_buffer &) = delete;
+
+    inline T* begin(){
+        return _data;
+    }
+
+    inline T* end(){
+        return _data + _size;
+    }
+
+private:
+    T* _data;
+    std::size_t _size;
+};
+
+
+// stable compaction of the elements flagged by flag_block to d_first
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename BlockFlagFunction>
+inline OutputIt _compact_copy(const ExecutionPolicy & policy, InputIt first, InputIt last, OutputIt d_first,
+                              BlockFlagFunction flag_block){
+    const std::size_t n_elems = std::distance(first, last);
+    const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+
+    std::vector<unsigned char> flags(n_elems);
+    const std::vector<std::size_t> offsets = _flag_blocks(policy, blocks, flags, flag_block);
+
+    _scatter_blocks(policy, blocks, flags, offsets, first, d_first, d_first, false, copy_assign());
+    return get_end_iterator(d_first, offsets.back());
+}
+
+
+// in place stable compaction of the elements flagged by flag_block, through a temporary buffer
+template<typename ExecutionPolicy, typename ForwardIt, typename BlockFlagFunction>
+inline ForwardIt _compact_in_place(const ExecutionPolicy & policy, ForwardIt first, ForwardIt last,
+                                   BlockFlagFunction flag_block){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    const std::size_t n_elems = std::distance(first, last);
+    const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+
+    std::vector<unsigned char> flags(n_elems);
+    const std::vector<std::size_t> offsets = _flag_blocks(policy, blocks, flags, flag_block);
+
+    _relocation_buffer<value_type> buffer(offsets.back());
+    _scatter_blocks(policy, blocks, flags, offsets, first, buffer.begin(), buffer.begin(), false, move_construct());
+
+    return ::hadoken::parallel::copy(policy, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()), first);
+}
+
+
+// in place stable partition, through a temporary buffer
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _partition_in_place(const ExecutionPolicy & policy, ForwardIt first, ForwardIt last, UnaryPredicate & p){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+    const std::size_t n_elems = std::distance(first, last);
+    const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+
+    std::vector<unsigned char> flags(n_elems);
+    const std::vector<std::size_t> offsets = _flag_blocks(policy, blocks, flags, [&](std::size_t block_id, unsigned char* f){
+        return _flag_if(first, blocks.block_first(block_id), blocks.block_last(block_id), f, p);
+    });
+
+    _relocation_buffer<value_type> buffer(n_elems);
+    _scatter_blocks(policy, blocks, flags, offsets, first, buffer.begin(),
+                    buffer.begin() + offsets.back(), true, move_construct());
+
+    ::hadoken::parallel::copy(policy, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()), first);
+    return get_end_iterator(first, offsets.back());
+}
+
+
+// true if the multi pass parallel version should be used
+template<typename ExecutionPolicy, typename InputIt>
+inline bool _use_parallel_compaction(const ExecutionPolicy & policy, InputIt first, InputIt last){
+    return is_parallel_policy(policy) && is_forward_iterator<InputIt>::value
+           && static_cast<std::size_t>(std::distance(first, last)) >= get_execution_parameters(policy).threshold();
+}
+
+
+//
+// each algorithm has a parallel version for forward iterators ( std::true_type )
+// and falls back to the standard algorithm otherwise ( std::false_type )
+//
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt>
+inline OutputIt _copy(const ExecutionPolicy & policy, InputIt first, InputIt last, OutputIt d_first, std::true_type){
+    if(is_parallel_policy(policy)){
+        ::hadoken::parallel::for_range(policy, first, last, [&](InputIt local_first, InputIt local_last){
+            std::copy(local_first, local_last, get_end_iterator(d_first, std::distance(first, local_first)));
+        });
+        return get_end_iterator(d_first, std::distance(first, last));
+    }
+    return std::copy(first, last, d_first);
+}
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt>
+inline OutputIt _copy(const ExecutionPolicy &, InputIt first, InputIt last, OutputIt d_first, std::false_type){
+    return std::copy(first, last, d_first);
+}
+
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename UnaryPredicate>
+inline OutputIt _copy_if(const ExecutionPolicy & policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate & p, std::true_type){
+    if(_use_parallel_compaction(policy, first, last)){
+        const block_decomposition blocks(std::distance(first, last), get_execution_parameters(policy));
+        return _compact_copy(policy, first, last, d_first, [&](std::size_t block_id, unsigned char* flags){
+            return _flag_if(first, blocks.block_first(block_id), blocks.block_last(block_id), flags, p);
+        });
+    }
+    return std::copy_if(first, last, d_first, p);
+}
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename UnaryPredicate>
+inline OutputIt _copy_if(const ExecutionPolicy &, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate & p, std::false_type){
+    return std::copy_if(first, last, d_first, p);
+}
+
+
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _remove_if(const ExecutionPolicy & policy, ForwardIt first, ForwardIt last, UnaryPredicate & p, std::true_type){
+    using reference = typename std::iterator_traits<ForwardIt>::reference;
+
+    if(_use_parallel_compaction(policy, first, last)){
+        const block_decomposition blocks(std::distance(first, last), get_execution_parameters(policy));
+        auto keep = [&p](reference v){
+            return !p(v);
+        };
+
+        return _compact_in_place(policy, first, last, [&](std::size_t block_id, unsigned char* flags){
+            return _flag_if(first, blocks.block_first(block_id), blocks.block_last(block_id), flags, keep);
+        });
+    }
+    return std::remove_if(first, last, p);
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _remove_if(const ExecutionPolicy &, ForwardIt first, ForwardIt last, UnaryPredicate & p, std::false_type){
+    return std::remove_if(first, last, p);
+}
+
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt1, typename OutputIt2, typename UnaryPredicate>
+inline std::pair<OutputIt1, OutputIt2> _partition_copy(const ExecutionPolicy & policy, InputIt first, InputIt last,
+                                                       OutputIt1 d_first_true, OutputIt2 d_first_false, UnaryPredicate & p, std::true_type){
+    if(_use_parallel_compaction(policy, first, last)){
+        const std::size_t n_elems = std::distance(first, last);
+        const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+
+        std::vector<unsigned char> flags(n_elems);
+        const std::vector<std::size_t> offsets = _flag_blocks(policy, blocks, flags, [&](std::size_t block_id, unsigned char* f){
+            return _flag_if(first, blocks.block_first(block_id), blocks.block_last(block_id), f, p);
+        });
+
+        _scatter_blocks(policy, blocks, flags, offsets, first, d_first_true, d_first_false, true, copy_assign());
+        return std::make_pair(get_end_iterator(d_first_true, offsets.back()),
+                              get_end_iterator(d_first_false, n_elems - offsets.back()));
+    }
+    return std::partition_copy(first, last, d_first_true, d_first_false, p);
+}
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt1, typename OutputIt2, typename UnaryPredicate>
+inline std::pair<OutputIt1, OutputIt2> _partition_copy(const ExecutionPolicy &, InputIt first, InputIt last,
+                                                       OutputIt1 d_first_true, OutputIt2 d_first_false, UnaryPredicate & p, std::false_type){
+    return std::partition_copy(first, last, d_first_true, d_first_false, p);
+}
+
+
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _partition(const ExecutionPolicy & policy, ForwardIt first, ForwardIt last, UnaryPredicate & p, std::true_type){
+    if(_use_parallel_compaction(policy, first, last)){
+        return _partition_in_place(policy, first, last, p);
+    }
+    return std::stable_partition(first, last, p);
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate>
+inline ForwardIt _partition(const ExecutionPolicy &, ForwardIt first, ForwardIt last, UnaryPredicate & p, std::false_type){
+    return std::stable_partition(first, last, p);
+}
+
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename BinaryPredicate>
+inline OutputIt _unique_copy(const ExecutionPolicy & policy, InputIt first, InputIt last, OutputIt d_first, BinaryPredicate & p, std::true_type){
+    if(_use_parallel_compaction(policy, first, last)){
+        const block_decomposition blocks(std::distance(first, last), get_execution_parameters(policy));
+        return _compact_copy(policy, first, last, d_first, [&](std::size_t block_id, unsigned char* flags){
+            return _flag_unique(first, blocks.block_first(block_id), blocks.block_last(block_id), flags, p);
+        });
+    }
+    return std::unique_copy(first, last, d_first, p);
+}
+
+template<typename ExecutionPolicy, typename InputIt, typename OutputIt, typename BinaryPredicate>
+inline OutputIt _unique_copy(const ExecutionPolicy &, InputIt first, InputIt last, OutputIt d_first, BinaryPredicate & p, std::false_type){
+    return std::unique_copy(first, last, d_first, p);
+}
+
+
+template<typename ExecutionPolicy, typename ForwardIt, typename BinaryPredicate>
+inline ForwardIt _unique(const ExecutionPolicy & policy, ForwardIt first, ForwardIt last, BinaryPredicate & p, std::true_type){
+    if(_use_parallel_compaction(policy, first, last)){
+        const block_decomposition blocks(std::distance(first, last), get_execution_parameters(policy));
+        return _compact_in_place(policy, first, last, [&](std::size_t block_id, unsigned char* flags){
+            return _flag_unique(first, blocks.block_first(block_id), blocks.block_last(block_id), flags, p);
+        });
+    }
+    return std::unique(first, last, p);
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename BinaryPredicate>
+inline ForwardIt _unique(const ExecutionPolicy &, ForwardIt first, ForwardIt last, BinaryPredicate & p, std::false_type){
+    return std::unique(first, last, p);
+}
+
+
+} // detail
+
+
+// parallel copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt >
+OutputIt copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first ){
+    return detail::_copy(policy, first, last, d_first, detail::are_forward_iterators<InputIt, OutputIt>());
+}
+
+
+// parallel copy_if algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+OutputIt copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p ){
+    return detail::_copy_if(policy, first, last, d_first, p, detail::are_forward_iterators<InputIt, OutputIt>());
+}
+
+
+// parallel remove_copy_if algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryPredicate >
+OutputIt remove_copy_if( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, UnaryPredicate p ){
+    using reference = typename std::iterator_traits<InputIt>::reference;
+
+    return ::hadoken::parallel::copy_if(policy, first, last, d_first, [&p](reference v){
+        return !p(v);
+    });
+}
+
+
+// parallel remove_if algorithm
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+ForwardIt remove_if( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p ){
+    return detail::_remove_if(policy, first, last, p, detail::is_relocatable_iterator<ForwardIt>());
+}
+
+
+// parallel partition_copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt1, class OutputIt2, class UnaryPredicate >
+std::pair<OutputIt1, OutputIt2> partition_copy( ExecutionPolicy&& policy, InputIt first, InputIt last,
+                                                OutputIt1 d_first_true, OutputIt2 d_first_false, UnaryPredicate p ){
+    return detail::_partition_copy(policy, first, last, d_first_true, d_first_false, p,
+                                   detail::are_forward_iterators<InputIt, OutputIt1, OutputIt2>());
+}
+
+
+// parallel partition algorithm, stable
+template< class ExecutionPolicy, class ForwardIt, class UnaryPredicate >
+ForwardIt partition( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p ){
+    return detail::_partition(policy, first, last, p, detail::is_relocatable_iterator<ForwardIt>());
+}
+
+
+// parallel unique_copy algorithm with predicate
+template< class ExecutionPolicy, class InputIt, class OutputIt, class BinaryPredicate >
+OutputIt unique_copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first, BinaryPredicate p ){
+    return detail::_unique_copy(policy, first, last, d_first, p, detail::are_forward_iterators<InputIt, OutputIt>());
+}
+
+
+// parallel unique_copy algorithm
+template< class ExecutionPolicy, class InputIt, class OutputIt >
+OutputIt unique_copy( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first ){
+    return ::hadoken::parallel::unique_copy(policy, first, last, d_first, std::equal_to<typename std::iterator_traits<InputIt>::value_type>());
+}
+
+
+// parallel unique algorithm with predicate
+template< class ExecutionPolicy, class ForwardIt, class BinaryPredicate >
+ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, BinaryPredicate p ){
+    return detail::_unique(policy, first, last, p, detail::is_relocatable_iterator<ForwardIt>());
+}
+
+
+// parallel unique algorithm
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt unique( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    return ::hadoken::parallel::unique(policy, first, last, std::equal_to<typename std::iterator_traits<ForwardIt>::value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_COPY_GENERIC_HPP
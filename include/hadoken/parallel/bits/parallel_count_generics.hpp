@@ -34,6 +34,7 @@
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_vector_generic.hpp"
 
 
 namespace hadoken{
@@ -56,7 +57,7 @@ typename std::iterator_traits<InputIterator>::difference_type
 
         ::hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first,
                                        InputIterator local_end){
-            result_type local_res = std::count_if(local_first, local_end, p);
+            result_type local_res = _chunk_count_if(use_simd_path<ExecutionPolicy, InputIterator>(), local_first, local_end, p);
             res += local_res;
         });
         return res;
@@ -75,7 +76,7 @@ typename std::iterator_traits<InputIterator>::difference_type
 
     return detail::_internal_count_if<ExecutionPolicy,
             InputIterator,
-            UnaryPredicate>(std::move(policy),
+            UnaryPredicate>(std::forward<ExecutionPolicy>(policy),
                                 first, last,
                                 p);
 }
@@ -87,7 +88,7 @@ typename std::iterator_traits<InputIterator>::difference_type
     using value_type = typename std::iterator_traits<InputIterator>::value_type;
 
     return detail::_internal_count_if<ExecutionPolicy,
-            InputIterator>(std::move(policy),
+            InputIterator>(std::forward<ExecutionPolicy>(policy),
                                 first, last,
                             [&value](const value_type & v){
         return (v == static_cast<value_type>(value));
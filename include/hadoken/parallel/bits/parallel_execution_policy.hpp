@@ -0,0 +1,366 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_EXECUTION_POLICY_HPP
+#define PARALLEL_EXECUTION_POLICY_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+/// chunk scheduling strategies of the parallel algorithms
+enum class schedule_type{
+    /// the range is cut in chunks of equal size, distributed once
+    static_schedule,
+    /// the range is cut in small chunks of fixed size, claimed on demand by the executors
+    dynamic_schedule,
+    /// the chunks size decreases with the remaining work, claimed on demand by the executors
+    guided_schedule,
+    /// the range is cut in blocks of fixed size, independent of the number of executors
+    deterministic_schedule
+};
+
+
+/// execution option: static chunk scheduling (default)
+class static_schedule{};
+
+/// execution option: dynamic chunk scheduling
+class dynamic_schedule{};
+
+/// execution option: guided chunk scheduling
+class guided_schedule{};
+
+/// execution option: deterministic chunk scheduling
+///
+/// the chunk boundaries depend only on the range size and on the grain or chunks options,
+/// never on the number of executors: results combined in chunk order
+/// ( reduce, inclusive_scan, for_loop reductions ) are reproducible between machines
+class deterministic_schedule{};
+
+/// constexpr for dynamic scheduling option
+constexpr dynamic_schedule dynamic{};
+
+/// constexpr for guided scheduling option
+constexpr guided_schedule guided{};
+
+/// constexpr for deterministic scheduling option
+constexpr deterministic_schedule deterministic{};
+
+
+/// execution option: minimum number of elements per chunk
+class grain{
+public:
+    constexpr explicit grain(std::size_t n_elems) : _n(n_elems){}
+
+    constexpr std::size_t value() const{
+        return _n;
+    }
+
+private:
+    std::size_t _n;
+};
+
+
+/// execution option: number of chunks the range is split into
+class chunks{
+public:
+    constexpr explicit chunks(std::size_t n_chunks) : _n(n_chunks){}
+
+    constexpr std::size_t value() const{
+        return _n;
+    }
+
+private:
+    std::size_t _n;
+};
+
+
+/// execution option: ranges of less than n elements are executed sequentially
+class sequential_threshold{
+public:
+    constexpr explicit sequential_threshold(std::size_t n_elems) : _n(n_elems){}
+
+    constexpr std::size_t value() const{
+        return _n;
+    }
+
+private:
+    std::size_t _n;
+};
+
+
+
+///
+/// \brief set of parameters carried by an execution policy
+///
+/// a value of 0 for grain or chunks means "decided by the scheduler"
+///
+class execution_parameters{
+public:
+    constexpr execution_parameters() :
+        _schedule(schedule_type::static_schedule),
+        _grain(0),
+        _chunks(0),
+        _threshold(0){}
+
+    constexpr execution_parameters(schedule_type sched, std::size_t grain_size, std::size_t n_chunks, std::size_t threshold) :
+        _schedule(sched),
+        _grain(grain_size),
+        _chunks(n_chunks),
+        _threshold(threshold){}
+
+    constexpr execution_parameters with(const static_schedule &) const{
+        return execution_parameters(schedule_type::static_schedule, _grain, _chunks, _threshold);
+    }
+
+    constexpr execution_parameters with(const dynamic_schedule &) const{
+        return execution_parameters(schedule_type::dynamic_schedule, _grain, _chunks, _threshold);
+    }
+
+    constexpr execution_parameters with(const guided_schedule &) const{
+        return execution_parameters(schedule_type::guided_schedule, _grain, _chunks, _threshold);
+    }
+
+    constexpr execution_parameters with(const deterministic_schedule &) const{
+        return execution_parameters(schedule_type::deterministic_schedule, _grain, _chunks, _threshold);
+    }
+
+    constexpr execution_parameters with(const grain & g) const{
+        return execution_parameters(_schedule, g.value(), _chunks, _threshold);
+    }
+
+    constexpr execution_parameters with(const chunks & c) const{
+        return execution_parameters(_schedule, _grain, c.value(), _threshold);
+    }
+
+    constexpr execution_parameters with(const sequential_threshold & t) const{
+        return execution_parameters(_schedule, _grain, _chunks, t.value());
+    }
+
+    constexpr schedule_type schedule() const{
+        return _schedule;
+    }
+
+    constexpr std::size_t grain_size() const{
+        return _grain;
+    }
+
+    constexpr std::size_t chunks_number() const{
+        return _chunks;
+    }
+
+    constexpr std::size_t threshold() const{
+        return _threshold;
+    }
+
+private:
+    schedule_type _schedule;
+    std::size_t _grain, _chunks, _threshold;
+};
+
+
+
+template<typename Policy, typename Executor>
+class executor_execution_policy;
+
+
+///
+/// \brief common base of the parallel execution policies
+///
+/// allow to attach execution options to a policy
+///
+/// \code
+///   parallel::for_each(parallel::par.with(parallel::grain(4096), parallel::dynamic), ...)
+/// \endcode
+///
+/// and to bind a policy to an executor
+///
+/// \code
+///   hadoken::thread_pool_executor pool(4);
+///   parallel::for_each(parallel::par.on(pool), ...)
+/// \endcode
+///
+template<typename Policy>
+class execution_policy_base{
+public:
+    constexpr execution_policy_base() : _params(){}
+
+    constexpr explicit execution_policy_base(const execution_parameters & params) : _params(params){}
+
+    /// return a copy of this policy with the option opt
+    template<typename Option>
+    constexpr Policy with(const Option & opt) const{
+        return static_cast<const Policy &>(*this).with_parameters(_params.with(opt));
+    }
+
+    /// return a copy of this policy with the options opt, opts...
+    template<typename Option, typename... Options>
+    constexpr Policy with(const Option & opt, const Options & ... opts) const{
+        return with(opt).with(opts...);
+    }
+
+    /// return a copy of this policy where the algorithms are executed on exec
+    ///
+    /// exec needs to provide execute(std::function<void (void)>) and
+    /// to outlive the algorithms using the policy
+    template<typename Executor>
+    executor_execution_policy<Policy, Executor> on(Executor & exec) const{
+        return executor_execution_policy<Policy, Executor>(exec, _params);
+    }
+
+    constexpr const execution_parameters & parameters() const{
+        return _params;
+    }
+
+private:
+    execution_parameters _params;
+};
+
+
+
+/// sequential execution, no parallelism
+class sequential_execution_policy{};
+
+/// parallel execution allowed
+class parallel_execution_policy : public execution_policy_base<parallel_execution_policy>{
+public:
+    constexpr parallel_execution_policy() : execution_policy_base<parallel_execution_policy>(){}
+
+    constexpr explicit parallel_execution_policy(const execution_parameters & params) :
+        execution_policy_base<parallel_execution_policy>(params){}
+
+    constexpr parallel_execution_policy with_parameters(const execution_parameters & params) const{
+        return parallel_execution_policy(params);
+    }
+};
+
+/// parallel execution allowed, vector execution allowed
+class parallel_vector_execution_policy : public execution_policy_base<parallel_vector_execution_policy>{
+public:
+    constexpr parallel_vector_execution_policy() : execution_policy_base<parallel_vector_execution_policy>(){}
+
+    constexpr explicit parallel_vector_execution_policy(const execution_parameters & params) :
+        execution_policy_base<parallel_vector_execution_policy>(params){}
+
+    constexpr parallel_vector_execution_policy with_parameters(const execution_parameters & params) const{
+        return parallel_vector_execution_policy(params);
+    }
+};
+
+
+/// parallel execution on a specific executor
+/// Policy is the policy the executor has been bound to
+template<typename Policy, typename Executor>
+class executor_execution_policy : public execution_policy_base<executor_execution_policy<Policy, Executor> >{
+public:
+    typedef Policy policy_type;
+    typedef Executor executor_type;
+
+    constexpr executor_execution_policy(Executor & exec, const execution_parameters & params) :
+        execution_policy_base<executor_execution_policy<Policy, Executor> >(params),
+        _exec(&exec){}
+
+    constexpr executor_execution_policy with_parameters(const execution_parameters & params) const{
+        return executor_execution_policy(*_exec, params);
+    }
+
+    constexpr Executor & executor() const{
+        return *_exec;
+    }
+
+private:
+    Executor* _exec;
+};
+
+
+/// constexpr for sequential execution
+constexpr sequential_execution_policy seq{};
+
+/// constexpr for parallel execution
+constexpr parallel_execution_policy par{};
+
+/// constexpr for parallel vector execution
+constexpr parallel_vector_execution_policy par_vec{};
+
+/// constexpr for reproducible parallel execution, equivalent to par.with(deterministic)
+constexpr parallel_execution_policy par_deterministic{execution_parameters().with(deterministic_schedule())};
+
+
+
+namespace detail{
+
+// determine if a policy type allows parallel execution
+template<typename ExecPolicy>
+struct is_parallel_execution_policy : public std::false_type{};
+
+template<>
+struct is_parallel_execution_policy<parallel_execution_policy> : public std::true_type{};
+
+template<>
+struct is_parallel_execution_policy<parallel_vector_execution_policy> : public std::true_type{};
+
+template<typename Policy, typename Executor>
+struct is_parallel_execution_policy<executor_execution_policy<Policy, Executor> > : public is_parallel_execution_policy<Policy>{};
+
+
+// determine if a policy type allows vectorised execution of the chunks
+template<typename T>
+struct is_vector_execution_policy : public std::false_type{};
+
+template<>
+struct is_vector_execution_policy<parallel_vector_execution_policy> : public std::true_type{};
+
+template<typename Policy, typename Executor>
+struct is_vector_execution_policy<executor_execution_policy<Policy, Executor> > : public is_vector_execution_policy<Policy>{};
+
+
+// execution parameters of a policy
+inline execution_parameters get_execution_parameters(const sequential_execution_policy & policy){
+    (void) policy;
+    return execution_parameters();
+}
+
+template<typename Policy>
+inline execution_parameters get_execution_parameters(const execution_policy_base<Policy> & policy){
+    return policy.parameters();
+}
+
+} // detail
+
+
+} // parallel
+
+} // hadoken
+
+#endif // PARALLEL_EXECUTION_POLICY_HPP
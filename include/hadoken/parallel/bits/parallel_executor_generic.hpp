@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_EXECUTOR_GENERIC_HPP
+#define PARALLEL_EXECUTOR_GENERIC_HPP
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/executor/thread_pool_executor.hpp>
+
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// number of executors worth to use on an executor, caller included
+template<typename Executor>
+inline std::size_t executor_concurrency(const Executor & exec){
+    (void) exec;
+    return std::thread::hardware_concurrency();
+}
+
+inline std::size_t executor_concurrency(const thread_pool_executor & exec){
+    return exec.size();
+}
+
+
+// state shared between the caller and the executor tasks of a for_range
+//
+// the tasks pushed on the executor can start after the end of the for_range
+// if the caller or other tasks already processed every chunk.
+// The state is consequently owned by all of them, and the range function
+// is only accessed after a successful chunk claim
+template<typename Iterator, typename RangeFunction>
+struct executor_for_range_state{
+    executor_for_range_state(std::size_t n_elems, std::size_t n_executors, const execution_parameters & params,
+                          Iterator first_it, RangeFunction & range_fun) :
+        scheduler(n_elems, n_executors, params, make_range_alignment(first_it, n_elems)),
+        active(0),
+        first(first_it),
+        fun(range_fun){}
+
+    inline void run(){
+        active.fetch_add(1);
+        run_scheduled_chunks(scheduler, first, fun);
+        active.fetch_sub(1);
+    }
+
+    chunk_scheduler scheduler;
+    std::atomic<std::size_t> active;
+    Iterator first;
+    RangeFunction & fun;
+};
+
+
+/// for_range algorithm executed on exec
+template<typename Executor, typename Iterator, typename RangeFunction>
+inline void _executor_for_range(const execution_parameters & params, Executor & exec,
+                                Iterator begin_it, Iterator end_it, RangeFunction & fun){
+    using state_type = executor_for_range_state<Iterator, RangeFunction>;
+
+    const std::size_t n_elems = std::distance(begin_it, end_it);
+
+    // the chunk functions are never called on an empty range
+    if(n_elems == 0){
+        return;
+    }
+
+    if(n_elems < params.threshold()){
+        fun(begin_it, end_it);
+        return;
+    }
+
+    std::shared_ptr<state_type> state = std::make_shared<state_type>(n_elems, executor_concurrency(exec), params, begin_it, fun);
+    const std::size_t n_task = state->scheduler.concurrency();
+
+    // start task for tasks 1-N on separated executors
+    for(std::size_t i = 1; i < n_task; ++i){
+         exec.execute([state](){
+            state->run();
+        });
+    }
+
+    // the caller participates to the execution
+    state->run();
+
+    // all chunks are claimed, wait for the ones still in progress
+    while(state->active.load() > 0){
+#ifndef HADOKEN_SPIN_NO_YIELD
+        std::this_thread::yield();
+#endif
+    }
+}
+
+
+// for_range on a policy bound to an executor
+template<typename Policy, typename Executor, typename Iterator, typename RangeFunction>
+inline void _executor_for_range(const executor_execution_policy<Policy, Executor> & policy,
+                                Iterator begin_it, Iterator end_it, RangeFunction & fun){
+    _executor_for_range(policy.parameters(), policy.executor(), begin_it, end_it, fun);
+}
+
+
+} // detail
+
+} // parallel
+
+} // hadoken
+
+#endif // PARALLEL_EXECUTOR_GENERIC_HPP
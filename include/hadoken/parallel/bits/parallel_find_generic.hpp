@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_FIND_GENERIC_HPP
+#define PARALLEL_FIND_GENERIC_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <hadoken/parallel/algorithm.hpp>
+
+
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+// find the first element satisfying p
+// a match at position N cancels the work of every chunk located after N
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator _internal_find_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    const std::size_t n_elems = std::distance(first, last);
+    cancellation_token found(n_elems);
+
+    hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&](InputIterator local_first, InputIterator local_end){
+        for_each_block_cancellable(found, std::distance(first, local_first), local_first, local_end,
+                                   [&](std::size_t offset, InputIterator block_first, InputIterator block_end){
+            InputIterator it = std::find_if(block_first, block_end, p);
+            if(it != block_end){
+                found.cancel_from(offset + std::distance(block_first, it));
+            }
+        });
+    });
+
+    return get_end_iterator(first, found.position());
+}
+
+} // detail
+
+
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline InputIterator find_if( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_find_if(std::forward<ExecutionPolicy>(policy), first, last, p);
+    }else{
+        return std::find_if(first, last, p);
+    }
+}
+
+
+template< class ExecutionPolicy, class InputIterator, class T >
+inline InputIterator find( ExecutionPolicy&& policy, InputIterator first, InputIterator last, const T & value ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_find_if(std::forward<ExecutionPolicy>(policy), first, last, [&value](reference v){
+            return (v == value);
+        });
+    }else{
+        return std::find(first, last, value);
+    }
+}
+
+
+template< class ExecutionPolicy, class InputIterator, class ForwardIterator, class BinaryPredicate >
+inline InputIterator find_first_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last,
+                                    ForwardIterator s_first, ForwardIterator s_last, BinaryPredicate p ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+    using s_reference = typename std::iterator_traits<ForwardIterator>::reference;
+
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_find_if(std::forward<ExecutionPolicy>(policy), first, last, [&](reference v){
+            return std::any_of(s_first, s_last, [&](s_reference s){
+                return p(v, s);
+            });
+        });
+    }else{
+        return std::find_first_of(first, last, s_first, s_last, p);
+    }
+}
+
+
+template< class ExecutionPolicy, class InputIterator, class ForwardIterator >
+inline InputIterator find_first_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last,
+                                    ForwardIterator s_first, ForwardIterator s_last ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
+    using s_reference = typename std::iterator_traits<ForwardIterator>::reference;
+
+    return find_first_of(std::forward<ExecutionPolicy>(policy), first, last, s_first, s_last, [](reference v, s_reference s){
+        return (v == s);
+    });
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_FIND_GENERIC_HPP
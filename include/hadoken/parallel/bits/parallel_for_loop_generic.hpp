@@ -0,0 +1,410 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_FOR_LOOP_GENERIC_HPP
+#define PARALLEL_FOR_LOOP_GENERIC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <hadoken/thread/spinlock.hpp>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+// C++11 replacement of std::index_sequence
+template<std::size_t... Is>
+struct index_sequence{};
+
+template<std::size_t N, std::size_t... Is>
+struct make_index_sequence_impl : public make_index_sequence_impl<N - 1, N - 1, Is...>{};
+
+template<std::size_t... Is>
+struct make_index_sequence_impl<0, Is...>{
+    typedef index_sequence<Is...> type;
+};
+
+template<std::size_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+
+/// no chunk local state
+struct no_local_state{};
+
+
+/// combiners of reduction_min and reduction_max, same result as std::min and std::max
+template<typename T>
+struct min_op{
+    inline const T & operator()(const T & a, const T & b) const{
+        return (b < a) ? b : a;
+    }
+};
+
+template<typename T>
+struct max_op{
+    inline const T & operator()(const T & a, const T & b) const{
+        return (a < b) ? b : a;
+    }
+};
+
+
+///
+/// reduction helper of for_loop: each chunk works on a private copy initialized
+/// to identity, the copies are combined to var at the end of the loop
+///
+template<typename T, typename BinaryOperation>
+class reduction_object{
+public:
+    typedef T local_type;
+
+    inline reduction_object(T & var, const T & identity, BinaryOperation combiner) :
+        _var(&var), _identity(identity), _combiner(std::move(combiner)){}
+
+    inline local_type make_local() const{
+        return _identity;
+    }
+
+    inline T & at(local_type & local, std::size_t iteration) const{
+        (void) iteration;
+        return local;
+    }
+
+    inline void combine(const local_type & local){
+        *_var = _combiner(*_var, local);
+    }
+
+    inline void finalize(std::size_t n_iterations){
+        (void) n_iterations;
+    }
+
+private:
+    T* _var;
+    T _identity;
+    BinaryOperation _combiner;
+};
+
+
+///
+/// induction helper of for_loop: the value seen by the iteration k is var + k * stride,
+/// var is set to its value after the last iteration when bound to a lvalue
+///
+template<typename T, typename S>
+class induction_object{
+public:
+    typedef no_local_state local_type;
+
+    inline induction_object(T* var, const T & value, S stride) :
+        _var(var), _value(value), _stride(stride){}
+
+    inline local_type make_local() const{
+        return local_type();
+    }
+
+    inline T at(local_type & local, std::size_t iteration) const{
+        (void) local;
+        return value_at(iteration);
+    }
+
+    inline void combine(const local_type & local){
+        (void) local;
+    }
+
+    inline void finalize(std::size_t n_iterations){
+        if(_var != nullptr){
+            *_var = value_at(n_iterations);
+        }
+    }
+
+private:
+    inline T value_at(std::size_t iteration) const{
+        return static_cast<T>(_value + static_cast<std::ptrdiff_t>(iteration) * _stride);
+    }
+
+    T* _var;
+    T _value;
+    S _stride;
+};
+
+
+// loop index of the iteration k
+template<typename I, typename S>
+inline I _loop_index(I start, std::size_t k, S stride, std::true_type){
+    return start + static_cast<I>(static_cast<std::ptrdiff_t>(k) * static_cast<std::ptrdiff_t>(stride));
+}
+
+template<typename I, typename S>
+inline I _loop_index(I start, std::size_t k, S stride, std::false_type){
+    std::advance(start, static_cast<std::ptrdiff_t>(k) * static_cast<std::ptrdiff_t>(stride));
+    return start;
+}
+
+
+/// true if the loop index of any iteration is computed in constant time:
+/// integral indexes and random access iterators
+template<typename I, bool Integral = std::is_integral<I>::value>
+struct is_random_access_index : public std::true_type{};
+
+template<typename I>
+struct is_random_access_index<I, false> : public std::is_base_of<std::random_access_iterator_tag,
+                                                                 typename std::iterator_traits<I>::iterator_category>{};
+
+
+// execute body(index, k) for the iterations [k_first, k_last) of a chunk
+template<typename I, typename S, typename Body>
+inline void _loop_chunk(I start, S stride, std::size_t k_first, std::size_t k_last, Body & body, std::true_type){
+    for(std::size_t k = k_first; k < k_last; ++k){
+        body(_loop_index(start, k, stride, std::is_integral<I>()), k);
+    }
+}
+
+// forward and bidirectional iterators: advance to the chunk start once, then step by stride
+template<typename I, typename S, typename Body>
+inline void _loop_chunk(I start, S stride, std::size_t k_first, std::size_t k_last, Body & body, std::false_type){
+    if(k_first >= k_last){
+        return;
+    }
+
+    I index = _loop_index(start, k_first, stride, std::false_type());
+    body(index, k_first);
+
+    // never step past the last iteration, the iterator could go beyond the end of the range
+    for(std::size_t k = k_first + 1; k < k_last; ++k){
+        std::advance(index, static_cast<std::ptrdiff_t>(stride));
+        body(index, k);
+    }
+}
+
+
+template<typename I>
+inline std::ptrdiff_t _loop_distance(I start, I finish, std::ptrdiff_t step, std::true_type){
+    (void) step;
+    return static_cast<std::ptrdiff_t>(finish) - static_cast<std::ptrdiff_t>(start);
+}
+
+// std::distance needs the last iterator reachable from the first one: start from finish for backward loops
+template<typename I>
+inline std::ptrdiff_t _loop_distance(I start, I finish, std::ptrdiff_t step, std::false_type){
+    return (step < 0) ? -std::distance(finish, start) : std::distance(start, finish);
+}
+
+
+// number of iterations of a strided loop [start, finish)
+template<typename I, typename S>
+inline std::size_t _loop_iterations(I start, I finish, S stride){
+    const std::ptrdiff_t step = static_cast<std::ptrdiff_t>(stride);
+    const std::ptrdiff_t distance = _loop_distance(start, finish, step, std::is_integral<I>());
+
+    if(step > 0 && distance > 0){
+        return static_cast<std::size_t>((distance + step - 1) / step);
+    }
+    if(step < 0 && distance < 0){
+        return static_cast<std::size_t>((-distance - step - 1) / (-step));
+    }
+    return 0;
+}
+
+
+template<typename ExecPolicy, typename I, typename S, typename Function, typename... Helpers, std::size_t... Is>
+inline void _for_loop_helpers(ExecPolicy && policy, I start, S stride, std::size_t n_iterations,
+                              Function & fun, std::tuple<Helpers & ...> helpers, index_sequence<Is...>){
+    using local_tuple = std::tuple<typename Helpers::local_type...>;
+    using offset_locals = std::pair<std::size_t, local_tuple>;
+    using iteration_iterator = boost::counting_iterator<std::size_t>;
+
+    std::vector<offset_locals> partials;
+    hadoken::thread::spin_lock partials_lock;
+
+    for_range(std::forward<ExecPolicy>(policy), iteration_iterator(0), iteration_iterator(n_iterations),
+              [&](iteration_iterator it_first, iteration_iterator it_last){
+        local_tuple locals(std::get<Is>(helpers).make_local()...);
+
+        auto body = [&](I index, std::size_t k){
+            fun(index, std::get<Is>(helpers).at(std::get<Is>(locals), k)...);
+        };
+        _loop_chunk(start, stride, *it_first, *it_last, body, is_random_access_index<I>());
+
+        std::lock_guard<hadoken::thread::spin_lock> _l(partials_lock);
+        partials.emplace_back(*it_first, std::move(locals));
+    });
+
+    // combine the chunk results in the order of the iterations
+    std::sort(partials.begin(), partials.end(), [](const offset_locals & p1, const offset_locals & p2){
+        return p1.first < p2.first;
+    });
+
+    for(auto & partial : partials){
+        (void) partial;
+        (void) std::initializer_list<int>{ (std::get<Is>(helpers).combine(std::get<Is>(partial.second)), 0)... };
+    }
+
+    (void) std::initializer_list<int>{ (std::get<Is>(helpers).finalize(n_iterations), 0)... };
+}
+
+
+template<typename ExecPolicy, typename I, typename S, typename... Args, std::size_t... Is>
+inline void _for_loop_unpack(ExecPolicy && policy, I start, I finish, S stride,
+                             std::tuple<Args & ...> args, index_sequence<Is...>){
+    auto & fun = std::get<sizeof...(Args) - 1>(args);
+
+    _for_loop_helpers(std::forward<ExecPolicy>(policy), start, stride, _loop_iterations(start, finish, stride),
+                      fun, std::tuple<typename std::tuple_element<Is, std::tuple<Args...> >::type & ...>(std::get<Is>(args)...),
+                      index_sequence<Is...>());
+}
+
+
+} // detail
+
+
+
+// reduction helper with identity and combiner
+template<typename T, typename BinaryOperation>
+detail::reduction_object<T, BinaryOperation> reduction(T & var, const T & identity, BinaryOperation combiner){
+    return detail::reduction_object<T, BinaryOperation>(var, identity, std::move(combiner));
+}
+
+// sum reduction helper
+template<typename T>
+detail::reduction_object<T, std::plus<T> > reduction_plus(T & var){
+    return detail::reduction_object<T, std::plus<T> >(var, T(), std::plus<T>());
+}
+
+// product reduction helper
+template<typename T>
+detail::reduction_object<T, std::multiplies<T> > reduction_multiplies(T & var){
+    return detail::reduction_object<T, std::multiplies<T> >(var, T(1), std::multiplies<T>());
+}
+
+// minimum reduction helper, the initial value of var is the identity
+template<typename T>
+detail::reduction_object<T, detail::min_op<T> > reduction_min(T & var){
+    return detail::reduction_object<T, detail::min_op<T> >(var, var, detail::min_op<T>());
+}
+
+// maximum reduction helper, the initial value of var is the identity
+template<typename T>
+detail::reduction_object<T, detail::max_op<T> > reduction_max(T & var){
+    return detail::reduction_object<T, detail::max_op<T> >(var, var, detail::max_op<T>());
+}
+
+
+// induction helper, var is updated at the end of the loop
+template<typename T, typename S>
+detail::induction_object<T, S> induction(T & var, S stride){
+    return detail::induction_object<T, S>(&var, var, stride);
+}
+
+template<typename T>
+detail::induction_object<T, std::ptrdiff_t> induction(T & var){
+    return detail::induction_object<T, std::ptrdiff_t>(&var, var, 1);
+}
+
+// induction helper on a value
+template<typename T, typename S>
+detail::induction_object<T, S> induction(const T & value, S stride){
+    return detail::induction_object<T, S>(nullptr, value, stride);
+}
+
+template<typename T>
+detail::induction_object<T, std::ptrdiff_t> induction(const T & value){
+    return detail::induction_object<T, std::ptrdiff_t>(nullptr, value, 1);
+}
+
+
+
+// for_loop_strided algorithm
+template<typename ExecPolicy, typename I, typename S, typename... Args>
+inline void for_loop_strided(ExecPolicy && policy, I start, I finish, S stride, Args && ... rest){
+    static_assert(sizeof...(Args) >= 1, "for_loop requires a function as last argument");
+
+    detail::_for_loop_unpack(std::forward<ExecPolicy>(policy), start, finish, stride,
+                             std::tuple<Args & ...>(rest...), detail::make_index_sequence<sizeof...(Args) - 1>());
+}
+
+// for_loop algorithm
+template<typename ExecPolicy, typename I, typename... Args>
+inline void for_loop(ExecPolicy && policy, I start, I finish, Args && ... rest){
+    ::hadoken::parallel::for_loop_strided(std::forward<ExecPolicy>(policy), start, finish, 1, std::forward<Args>(rest)...);
+}
+
+// for_loop_n algorithm
+template<typename ExecPolicy, typename I, typename Size, typename... Args>
+inline void for_loop_n(ExecPolicy && policy, I start, Size n, Args && ... rest){
+    ::hadoken::parallel::for_loop_strided(std::forward<ExecPolicy>(policy), start,
+                                          detail::_loop_index(start, static_cast<std::size_t>(n), 1, std::is_integral<I>()),
+                                          1, std::forward<Args>(rest)...);
+}
+
+
+// for_range algorithm over 2D tiles
+template<typename ExecPolicy, typename RowValue, typename ColValue, typename TileFunction>
+inline void for_range(ExecPolicy && policy, const blocked_range2d<RowValue, ColValue> & range, TileFunction fun){
+    using tile_iterator = boost::counting_iterator<std::size_t>;
+
+    ::hadoken::parallel::for_range(std::forward<ExecPolicy>(policy), tile_iterator(0), tile_iterator(range.size()),
+                                   [&](tile_iterator tile_first, tile_iterator tile_last){
+        for(; tile_first != tile_last; ++tile_first){
+            fun(range.tile(*tile_first));
+        }
+    });
+}
+
+
+// for_each_n algorithm
+template<typename ExecPolicy, typename Iterator, typename Size, typename Function>
+inline Iterator for_each_n(ExecPolicy && policy, Iterator first, Size n, Function fun){
+    Iterator last = detail::get_end_iterator(first, n);
+    ::hadoken::parallel::for_each(std::forward<ExecPolicy>(policy), first, last, std::move(fun));
+    return last;
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_FOR_LOOP_GENERIC_HPP
@@ -30,9 +30,14 @@
 #define PARALLEL_GENERIC_UTILS_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <iterator>
+#include <vector>
 
 
 #include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/utility/range.hpp>
 
 namespace hadoken{
 
@@ -53,14 +58,283 @@ inline Iterator get_end_iterator(Iterator first, Size n){
 template<typename ExecPolicy>
 inline bool is_parallel_policy(const ExecPolicy & policy){
     (void ) policy;
-    if(std::is_same<ExecPolicy, parallel_execution_policy>::value
-            || std::is_same<ExecPolicy, parallel_vector_execution_policy>::value ){
+    return is_parallel_execution_policy<ExecPolicy>::value;
+}
+
+
+/// default number of chunks per executor
+/// for the dynamic scheduling
+constexpr std::size_t dynamic_chunks_per_executor = 16;
+
+/// default number of elements per block of the multi pass algorithms
+/// and of the deterministic scheduling
+constexpr std::size_t default_block_size = 4096;
+
+///
+/// \brief split a range of n elements in chunks following the execution parameters
+///  and distribute them to the executors on demand
+///
+/// the chunk boundaries only depend on the range size, the number of executors and
+/// the parameters: chunk(id) can be used directly by index based runtimes (OpenMP for loops)
+/// and next() claims the next chunk for runtimes without worksharing support.
+/// next() is thread safe and can be called concurrently by all the executors
+///
+/// with the static and dynamic schedules, the boundaries are rounded following alignment
+/// when the chunks are large enough: chunks of contiguous ranges do not share cache lines.
+/// The deterministic schedule is never aligned, its boundaries can not depend on memory addresses
+///
+class chunk_scheduler{
+public:
+    inline chunk_scheduler(std::size_t n_elems, std::size_t n_executors, const execution_parameters & params,
+                           const range_alignment & alignment = range_alignment()) :
+        _n_elems(n_elems),
+        _n_executors(std::max<std::size_t>(n_executors, 1)),
+        _schedule(params.schedule()),
+        _n_chunks(0),
+        _chunk_size(0),
+        _guided_limits(),
+        _alignment(),
+        _next(0){
+
+        switch(_schedule){
+            case schedule_type::static_schedule:{
+                if(params.chunks_number() > 0){
+                    _n_chunks = params.chunks_number();
+                }else if(params.grain_size() > 0){
+                    _n_chunks = (_n_elems + params.grain_size() -1) / params.grain_size();
+                }else{
+                    _n_chunks = _n_executors;
+                }
+                _n_chunks = std::min(_n_chunks, _n_elems);
+                if(_n_chunks > 0 && _n_elems / _n_chunks >= 2 * alignment.step()){
+                    _alignment = alignment;
+                }
+                break;
+            }
+            case schedule_type::dynamic_schedule:{
+                if(params.grain_size() > 0){
+                    _chunk_size = params.grain_size();
+                }else if(params.chunks_number() > 0){
+                    _chunk_size = (_n_elems + params.chunks_number() -1) / params.chunks_number();
+                }else{
+                    _chunk_size = _n_elems / (_n_executors * dynamic_chunks_per_executor);
+                }
+                _chunk_size = std::max<std::size_t>(_chunk_size, 1);
+                _n_chunks = (_n_elems + _chunk_size -1) / _chunk_size;
+                if(_chunk_size >= 2 * alignment.step()){
+                    _alignment = alignment;
+                }
+                break;
+            }
+            case schedule_type::deterministic_schedule:{
+                if(params.grain_size() > 0){
+                    _chunk_size = params.grain_size();
+                }else if(params.chunks_number() > 0){
+                    _chunk_size = (_n_elems + params.chunks_number() -1) / params.chunks_number();
+                }else{
+                    _chunk_size = default_block_size;
+                }
+                _chunk_size = std::max<std::size_t>(_chunk_size, 1);
+                _n_chunks = (_n_elems + _chunk_size -1) / _chunk_size;
+                break;
+            }
+            case schedule_type::guided_schedule:{
+                // the size of a guided chunk is proportional to the remaining work
+                // grain is the minimum chunk size
+                const std::size_t min_size = std::max<std::size_t>(params.grain_size(), 1);
+                std::size_t pos = 0;
+                while(pos < _n_elems){
+                    std::size_t size = std::max(min_size, (_n_elems - pos) / (2 * _n_executors));
+                    pos += std::min(size, _n_elems - pos);
+                    _guided_limits.push_back(pos);
+                }
+                _n_chunks = _guided_limits.size();
+                break;
+            }
+        }
+    }
+
+    /// total number of chunks
+    inline std::size_t size() const{
+        return _n_chunks;
+    }
+
+    /// number of executors worth to be used
+    inline std::size_t concurrency() const{
+        return std::min(_n_executors, _n_chunks);
+    }
+
+    /// boundaries [chunk_first, chunk_last) of the chunk chunk_id
+    inline void chunk(std::size_t chunk_id, std::size_t & chunk_first, std::size_t & chunk_last) const{
+        switch(_schedule){
+            case schedule_type::static_schedule:{
+                const std::size_t elem_per_chunk = _n_elems / _n_chunks;
+                const std::size_t elem_modulo = _n_elems % _n_chunks;
+                chunk_first = elem_per_chunk * chunk_id + std::min(elem_modulo, chunk_id);
+                chunk_last = chunk_first + elem_per_chunk + ((chunk_id < elem_modulo) ? 1 : 0);
+                chunk_first = _alignment.align(chunk_first, _n_elems);
+                chunk_last = _alignment.align(chunk_last, _n_elems);
+                break;
+            }
+            case schedule_type::dynamic_schedule:{
+                chunk_first = _alignment.align(chunk_id * _chunk_size, _n_elems);
+                chunk_last = _alignment.align(std::min(_n_elems, (chunk_id + 1) * _chunk_size), _n_elems);
+                break;
+            }
+            case schedule_type::deterministic_schedule:{
+                chunk_first = chunk_id * _chunk_size;
+                chunk_last = std::min(_n_elems, chunk_first + _chunk_size);
+                break;
+            }
+            case schedule_type::guided_schedule:
+            default:{
+                chunk_first = ((chunk_id == 0) ? 0 : _guided_limits[chunk_id -1]);
+                chunk_last = _guided_limits[chunk_id];
+                break;
+            }
+        }
+    }
+
+    ///
+    /// \brief claim the next chunk [chunk_first, chunk_last) of the range
+    /// \return false if the whole range has already been distributed
+    ///
+    inline bool next(std::size_t & chunk_first, std::size_t & chunk_last){
+        const std::size_t chunk_id = _next.fetch_add(1);
+        if(chunk_id >= _n_chunks){
+            return false;
+        }
+        chunk(chunk_id, chunk_first, chunk_last);
         return true;
     }
-    return false;
+
+private:
+    chunk_scheduler(const chunk_scheduler &) = delete;
+    chunk_scheduler & operator=(const chunk_scheduler &) = delete;
+
+    const std::size_t _n_elems, _n_executors;
+    const schedule_type _schedule;
+    std::size_t _n_chunks, _chunk_size;
+    std::vector<std::size_t> _guided_limits;
+    range_alignment _alignment;
+    std::atomic<std::size_t> _next;
+};
+
+
+/// execute fun on every chunk that can still be claimed from the scheduler
+template<typename Iterator, typename RangeFunction>
+inline void run_scheduled_chunks(chunk_scheduler & scheduler, Iterator first, RangeFunction & fun){
+    std::size_t chunk_first, chunk_last;
+    while(scheduler.next(chunk_first, chunk_last)){
+        fun(get_end_iterator(first, chunk_first), get_end_iterator(first, chunk_last));
+    }
+}
+
+
+/// number of elements processed by a chunk between two checks
+/// of its cancellation token
+constexpr std::size_t cancellation_check_interval = 1024;
+
+///
+/// \brief cooperative cancellation token shared by the chunks of a parallel algorithm
+///
+/// the token stores a position in the global range, any work located
+/// at or after this position is useless and can be dropped
+/// cancel() drops everything, cancel_from(pos) drops everything after pos
+///
+class cancellation_token{
+public:
+    inline cancellation_token(std::size_t limit = std::numeric_limits<std::size_t>::max()) : _limit(limit){}
+
+    /// cancel all the work located at or after pos
+    inline void cancel_from(std::size_t pos){
+        std::size_t current = _limit.load(std::memory_order_relaxed);
+        while(pos < current
+              && _limit.compare_exchange_weak(current, pos, std::memory_order_relaxed) == false){
+        }
+    }
+
+    /// cancel all the work
+    inline void cancel(){
+        cancel_from(0);
+    }
+
+    /// return true if the work at position pos is useless
+    inline bool is_cancelled(std::size_t pos = 0) const{
+        return (pos >= _limit.load(std::memory_order_relaxed));
+    }
+
+    /// current cancellation position
+    inline std::size_t position() const{
+        return _limit.load(std::memory_order_relaxed);
+    }
+
+private:
+    cancellation_token(const cancellation_token &) = delete;
+    cancellation_token & operator=(const cancellation_token &) = delete;
+
+    std::atomic<std::size_t> _limit;
+};
+
+
+/// execute fun(offset, block_first, block_last) on [first, last) by blocks of
+/// cancellation_check_interval elements, offset is the position of block_first
+/// in the global range
+///
+/// the iteration stops as soon as the token cancels the current block
+template<typename Iterator, typename BlockFunction>
+inline void for_each_block_cancellable(const cancellation_token & token, std::size_t offset,
+                                       Iterator first, Iterator last, BlockFunction fun){
+    std::size_t remain = std::distance(first, last);
+
+    while(remain > 0 && token.is_cancelled(offset) == false){
+        const std::size_t block_size = std::min(remain, cancellation_check_interval);
+        Iterator block_last = get_end_iterator(first, block_size);
+
+        fun(offset, first, block_last);
+
+        first = block_last;
+        offset += block_size;
+        remain -= block_size;
+    }
 }
 
 
+///
+/// \brief fixed decomposition of a range in blocks of equal size
+///
+/// used by the algorithms executing several passes over the same range
+/// ( count, scan, scatter ): the blocks do not depend on the chunks
+/// distributed by for_range and remain the same between the passes
+///
+/// the block size is the grain of the execution parameters when specified
+///
+class block_decomposition{
+public:
+    inline block_decomposition(std::size_t n_elems, const execution_parameters & params) :
+        _n_elems(n_elems),
+        _block_size((params.grain_size() > 0) ? params.grain_size() : default_block_size){}
+
+    /// number of blocks
+    inline std::size_t size() const{
+        return (_n_elems + _block_size - 1) / _block_size;
+    }
+
+    /// position of the first element of block block_id
+    inline std::size_t block_first(std::size_t block_id) const{
+        return block_id * _block_size;
+    }
+
+    /// position after the last element of block block_id
+    inline std::size_t block_last(std::size_t block_id) const{
+        return std::min(_n_elems, (block_id + 1) * _block_size);
+    }
+
+private:
+    std::size_t _n_elems, _block_size;
+};
+
+
 
 
 } //detail
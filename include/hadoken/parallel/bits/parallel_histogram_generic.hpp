@@ -0,0 +1,347 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_HISTOGRAM_GENERIC_HPP
+#define PARALLEL_HISTOGRAM_GENERIC_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_copy_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+/// above this number of bins, histogram partitions the keys by bin ranges
+/// instead of privatising the full histogram for each executor
+constexpr std::size_t histogram_private_bins_limit = 1 << 15;
+
+/// number of bins of a partition of the radix histogram
+constexpr std::size_t histogram_radix_bucket_bins = 4096;
+
+
+template<typename T>
+struct _unit_weight{
+    template<typename Value>
+    inline T operator()(const Value &) const{
+        return T(1);
+    }
+};
+
+
+/// pool of private histograms: a chunk takes a free histogram and gives it back after use,
+/// no more histograms than concurrent chunks are ever allocated
+template<typename T>
+class private_bins_pool{
+public:
+    typedef std::vector<T> bins_type;
+
+    inline private_bins_pool(std::size_t n_bins) : _n_bins(n_bins){}
+
+    inline bins_type* acquire(){
+        std::lock_guard<std::mutex> lock(_lock);
+        if(_free.empty()){
+            _bins.emplace_back(new bins_type(_n_bins, T()));
+            return _bins.back().get();
+        }
+        bins_type* res = _free.back();
+        _free.pop_back();
+        return res;
+    }
+
+    inline void release(bins_type* bins){
+        std::lock_guard<std::mutex> lock(_lock);
+        _free.push_back(bins);
+    }
+
+    inline const std::vector<std::unique_ptr<bins_type> > & all() const{
+        return _bins;
+    }
+
+private:
+    std::size_t _n_bins;
+    std::mutex _lock;
+    std::vector<std::unique_ptr<bins_type> > _bins;
+    std::vector<bins_type*> _free;
+};
+
+
+// histogram with private bins merged at the end
+template<typename ExecutionPolicy, typename InputIt, typename RandomIt, typename KeyFunction, typename WeightFunction>
+inline void _histogram_private(const ExecutionPolicy & policy, InputIt first, InputIt last, RandomIt bins_first, std::size_t n_bins,
+                               KeyFunction & keyfn, WeightFunction & weightfn){
+    using bin_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    private_bins_pool<bin_type> pool(n_bins);
+
+    ::hadoken::parallel::for_range(policy, first, last, [&](InputIt local_first, InputIt local_last){
+        typename private_bins_pool<bin_type>::bins_type* local_bins = pool.acquire();
+        for(; local_first != local_last; ++local_first){
+            (*local_bins)[keyfn(*local_first)] += weightfn(*local_first);
+        }
+        pool.release(local_bins);
+    });
+
+    const auto & private_bins = pool.all();
+    ::hadoken::parallel::for_range(policy, block_id_iterator(0), block_id_iterator(n_bins),
+                                   [&](block_id_iterator b_first, block_id_iterator b_last){
+        for(const auto & local_bins : private_bins){
+            for(block_id_iterator b = b_first; b != b_last; ++b){
+                bins_first[*b] += (*local_bins)[*b];
+            }
+        }
+    });
+}
+
+
+/// radix histogram for large number of bins:
+/// keys and weights are partitioned by ranges of histogram_radix_bucket_bins bins,
+/// each range of bins is then updated by a single task
+template<typename ExecutionPolicy, typename InputIt, typename RandomIt, typename KeyFunction, typename WeightFunction>
+inline void _histogram_radix(const ExecutionPolicy & policy, InputIt first, InputIt last, RandomIt bins_first, std::size_t n_bins,
+                             KeyFunction & keyfn, WeightFunction & weightfn){
+    using bin_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t n_elems = std::distance(first, last);
+    const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+    const std::size_t n_blocks = blocks.size();
+    const std::size_t n_buckets = (n_bins + histogram_radix_bucket_bins - 1) / histogram_radix_bucket_bins;
+
+    std::vector<std::size_t> keys(n_elems);
+    std::vector<bin_type> weights(n_elems);
+
+    // bucket major counts: their scan gives the scatter offset of each block in each bucket
+    std::vector<std::size_t> offsets(n_buckets * n_blocks + 1, 0);
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        InputIt it = get_end_iterator(first, blocks.block_first(block_id));
+        for(std::size_t pos = blocks.block_first(block_id); pos < blocks.block_last(block_id); ++pos, ++it){
+            keys[pos] = keyfn(*it);
+            weights[pos] = weightfn(*it);
+            offsets[(keys[pos] / histogram_radix_bucket_bins) * n_blocks + block_id + 1] += 1;
+        }
+    });
+
+    ::hadoken::parallel::inclusive_scan(_block_policy(policy), offsets.begin() + 1, offsets.end(), offsets.begin() + 1);
+
+    std::vector<std::pair<std::size_t, bin_type> > partitioned(n_elems);
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        std::vector<std::size_t> local_offsets(n_buckets);
+        for(std::size_t bucket = 0; bucket < n_buckets; ++bucket){
+            local_offsets[bucket] = offsets[bucket * n_blocks + block_id];
+        }
+        for(std::size_t pos = blocks.block_first(block_id); pos < blocks.block_last(block_id); ++pos){
+            partitioned[local_offsets[keys[pos] / histogram_radix_bucket_bins]++] = std::make_pair(keys[pos], std::move(weights[pos]));
+        }
+    });
+
+    ::hadoken::parallel::for_range(_block_policy(policy), block_id_iterator(0), block_id_iterator(n_buckets),
+                                   [&](block_id_iterator b_first, block_id_iterator b_last){
+        for(; b_first != b_last; ++b_first){
+            const std::size_t pos_last = offsets[(*b_first + 1) * n_blocks];
+            for(std::size_t pos = offsets[*b_first * n_blocks]; pos < pos_last; ++pos){
+                bins_first[partitioned[pos].first] += partitioned[pos].second;
+            }
+        }
+    });
+}
+
+
+// sequential reduce_by_key, for any iterator
+template<typename InputIt1, typename InputIt2, typename OutputIt1, typename OutputIt2,
+         typename BinaryPredicate, typename BinaryOperation>
+inline std::pair<OutputIt1, OutputIt2> _reduce_by_key_sequential(InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                                                 OutputIt1 keys_out, OutputIt2 values_out,
+                                                                 BinaryPredicate & pred, BinaryOperation & op){
+    using value_type = typename std::iterator_traits<InputIt2>::value_type;
+
+    if(keys_first == keys_last){
+        return std::make_pair(keys_out, values_out);
+    }
+
+    // consecutive keys are compared, as for unique
+    InputIt1 prev = keys_first;
+    *keys_out = *keys_first;
+    value_type acc = *values_first;
+
+    for(++keys_first, ++values_first; keys_first != keys_last; ++prev, ++keys_first, ++values_first){
+        if(pred(*prev, *keys_first)){
+            acc = op(acc, *values_first);
+            continue;
+        }
+        *values_out = std::move(acc);
+        ++keys_out;
+        ++values_out;
+        *keys_out = *keys_first;
+        acc = *values_first;
+    }
+
+    *values_out = std::move(acc);
+    return std::make_pair(++keys_out, ++values_out);
+}
+
+
+// block parallel reduce_by_key, for forward iterators only ( std::true_type )
+template<typename ExecutionPolicy, typename InputIt1, typename InputIt2, typename OutputIt1, typename OutputIt2,
+         typename BinaryPredicate, typename BinaryOperation>
+inline std::pair<OutputIt1, OutputIt2> _reduce_by_key(const ExecutionPolicy & policy, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                                      OutputIt1 keys_out, OutputIt2 values_out,
+                                                      BinaryPredicate & pred, BinaryOperation & op, std::true_type){
+    using value_type = typename std::iterator_traits<InputIt2>::value_type;
+
+    if(_use_parallel_compaction(policy, keys_first, keys_last) == false){
+        return _reduce_by_key_sequential(keys_first, keys_last, values_first, keys_out, values_out, pred, op);
+    }
+
+    const std::size_t n_elems = std::distance(keys_first, keys_last);
+    const block_decomposition blocks(n_elems, get_execution_parameters(policy));
+
+    // one flag at the head of each run of equivalent keys
+    std::vector<unsigned char> flags(n_elems);
+    const std::vector<std::size_t> offsets = _flag_blocks(policy, blocks, flags, [&](std::size_t block_id, unsigned char* flags_ptr){
+        return _flag_unique(keys_first, blocks.block_first(block_id), blocks.block_last(block_id), flags_ptr, pred);
+    });
+
+    // each block reduces the runs starting inside it, until their end
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        std::size_t pos = blocks.block_first(block_id);
+        const std::size_t pos_last = blocks.block_last(block_id);
+
+        while(pos < pos_last && flags[pos] == false){
+            ++pos;
+        }
+
+        InputIt1 key_it = get_end_iterator(keys_first, pos);
+        InputIt2 value_it = get_end_iterator(values_first, pos);
+        OutputIt1 key_out = get_end_iterator(keys_out, offsets[block_id]);
+        OutputIt2 value_out = get_end_iterator(values_out, offsets[block_id]);
+
+        while(pos < pos_last){
+            *key_out = *key_it;
+            value_type acc = *value_it;
+
+            for(++pos, ++key_it, ++value_it; pos < n_elems && flags[pos] == false; ++pos, ++key_it, ++value_it){
+                acc = op(acc, *value_it);
+            }
+
+            *value_out = std::move(acc);
+            ++key_out;
+            ++value_out;
+        }
+    });
+
+    return std::make_pair(get_end_iterator(keys_out, offsets.back()),
+                          get_end_iterator(values_out, offsets.back()));
+}
+
+template<typename ExecutionPolicy, typename InputIt1, typename InputIt2, typename OutputIt1, typename OutputIt2,
+         typename BinaryPredicate, typename BinaryOperation>
+inline std::pair<OutputIt1, OutputIt2> _reduce_by_key(const ExecutionPolicy &, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                                      OutputIt1 keys_out, OutputIt2 values_out,
+                                                      BinaryPredicate & pred, BinaryOperation & op, std::false_type){
+    return _reduce_by_key_sequential(keys_first, keys_last, values_first, keys_out, values_out, pred, op);
+}
+
+
+} // detail
+
+
+
+// parallel histogram algorithm with weights
+template< class ExecutionPolicy, class InputIt, class RandomIt, class KeyFunction, class WeightFunction >
+void histogram( ExecutionPolicy&& policy, InputIt first, InputIt last, RandomIt bins_first, RandomIt bins_last,
+                KeyFunction keyfn, WeightFunction weightfn ){
+    const std::size_t n_bins = std::distance(bins_first, bins_last);
+
+    if(detail::_use_parallel_compaction(policy, first, last) && n_bins > 0){
+        if(n_bins > detail::histogram_private_bins_limit){
+            detail::_histogram_radix(policy, first, last, bins_first, n_bins, keyfn, weightfn);
+        }else{
+            detail::_histogram_private(policy, first, last, bins_first, n_bins, keyfn, weightfn);
+        }
+        return;
+    }
+
+    for(; first != last; ++first){
+        bins_first[keyfn(*first)] += weightfn(*first);
+    }
+}
+
+
+// parallel histogram algorithm
+template< class ExecutionPolicy, class InputIt, class RandomIt, class KeyFunction >
+void histogram( ExecutionPolicy&& policy, InputIt first, InputIt last, RandomIt bins_first, RandomIt bins_last, KeyFunction keyfn ){
+    using bin_type = typename std::iterator_traits<RandomIt>::value_type;
+    ::hadoken::parallel::histogram(std::forward<ExecutionPolicy>(policy), first, last, bins_first, bins_last, keyfn,
+                                   detail::_unit_weight<bin_type>());
+}
+
+
+
+// parallel reduce_by_key algorithm with predicate and binary operation
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt1, class OutputIt2,
+          class BinaryPredicate, class BinaryOperation >
+std::pair<OutputIt1, OutputIt2> reduce_by_key( ExecutionPolicy&& policy, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                               OutputIt1 keys_out, OutputIt2 values_out,
+                                               BinaryPredicate pred, BinaryOperation op ){
+    return detail::_reduce_by_key(policy, keys_first, keys_last, values_first, keys_out, values_out, pred, op,
+                                  detail::are_forward_iterators<InputIt1, InputIt2, OutputIt1, OutputIt2>());
+}
+
+
+// parallel reduce_by_key algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt1, class OutputIt2 >
+std::pair<OutputIt1, OutputIt2> reduce_by_key( ExecutionPolicy&& policy, InputIt1 keys_first, InputIt1 keys_last, InputIt2 values_first,
+                                               OutputIt1 keys_out, OutputIt2 values_out ){
+    using key_type = typename std::iterator_traits<InputIt1>::value_type;
+    using value_type = typename std::iterator_traits<InputIt2>::value_type;
+    return ::hadoken::parallel::reduce_by_key(std::forward<ExecutionPolicy>(policy), keys_first, keys_last, values_first,
+                                              keys_out, values_out, std::equal_to<key_type>(), std::plus<value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_HISTOGRAM_GENERIC_HPP
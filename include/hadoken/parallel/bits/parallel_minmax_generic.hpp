@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_MINMAX_GENERIC_HPP
+#define PARALLEL_MINMAX_GENERIC_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <utility>
+
+#include <hadoken/thread/spinlock.hpp>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+/// element candidate of a chunk and its position in the global range
+template<typename Iterator>
+struct element_candidate{
+    inline element_candidate(Iterator it, std::size_t position) : iterator(it), pos(position){}
+
+    Iterator iterator;
+    std::size_t pos;
+};
+
+
+// replace best by candidate if candidate is smaller, or equivalent and located before
+template<typename Iterator, typename Compare>
+inline void _select_first_min(element_candidate<Iterator> & best, const element_candidate<Iterator> & candidate, Compare & comp){
+    if(comp(*candidate.iterator, *best.iterator)
+       || (!comp(*best.iterator, *candidate.iterator) && candidate.pos < best.pos)){
+        best = candidate;
+    }
+}
+
+// replace best by candidate if candidate is larger, or equivalent and located before
+template<typename Iterator, typename Compare>
+inline void _select_first_max(element_candidate<Iterator> & best, const element_candidate<Iterator> & candidate, Compare & comp){
+    if(comp(*best.iterator, *candidate.iterator)
+       || (!comp(*candidate.iterator, *best.iterator) && candidate.pos < best.pos)){
+        best = candidate;
+    }
+}
+
+// replace best by candidate if candidate is larger, or equivalent and located after
+template<typename Iterator, typename Compare>
+inline void _select_last_max(element_candidate<Iterator> & best, const element_candidate<Iterator> & candidate, Compare & comp){
+    if(comp(*best.iterator, *candidate.iterator)
+       || (!comp(*candidate.iterator, *best.iterator) && candidate.pos > best.pos)){
+        best = candidate;
+    }
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+std::pair<ForwardIt, ForwardIt> _internal_minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                                                          Compare & comp){
+    using candidate = element_candidate<ForwardIt>;
+
+    candidate min_res(last, 0), max_res(last, 0);
+    bool initialized = false;
+    hadoken::thread::spin_lock res_lock;
+
+    for_range(policy, first, last, [&](ForwardIt local_first, ForwardIt local_last){
+        const std::size_t offset = std::distance(first, local_first);
+        const std::pair<ForwardIt, ForwardIt> local_res = std::minmax_element(local_first, local_last, comp);
+
+        const candidate local_min(local_res.first, offset + std::distance(local_first, local_res.first));
+        const candidate local_max(local_res.second, offset + std::distance(local_first, local_res.second));
+
+        std::lock_guard<hadoken::thread::spin_lock> _l(res_lock);
+        if(initialized == false){
+            min_res = local_min;
+            max_res = local_max;
+            initialized = true;
+            return;
+        }
+        _select_first_min(min_res, local_min, comp);
+        _select_last_max(max_res, local_max, comp);
+    });
+
+    return std::make_pair(min_res.iterator, max_res.iterator);
+}
+
+
+template< class ExecutionPolicy, class ForwardIt, class Compare, class ChunkSelect, class Select >
+ForwardIt _internal_select_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                                    Compare & comp, ChunkSelect chunk_select, Select select){
+    using candidate = element_candidate<ForwardIt>;
+
+    candidate res(last, 0);
+    hadoken::thread::spin_lock res_lock;
+
+    for_range(policy, first, last, [&](ForwardIt local_first, ForwardIt local_last){
+        ForwardIt local_res = chunk_select(local_first, local_last, comp);
+        const candidate local(local_res, std::distance(first, local_res));
+
+        std::lock_guard<hadoken::thread::spin_lock> _l(res_lock);
+        if(res.iterator == last){
+            res = local;
+            return;
+        }
+        select(res, local, comp);
+    });
+
+    return res.iterator;
+}
+
+
+} // detail
+
+
+// parallel min_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_select_element(std::forward<ExecutionPolicy>(policy), first, last, comp,
+                                                [](ForwardIt f, ForwardIt l, Compare & c){ return std::min_element(f, l, c); },
+                                                detail::_select_first_min<ForwardIt, Compare>);
+    }
+    return std::min_element(first, last, comp);
+}
+
+// parallel min_element algorithm
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt min_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    return ::hadoken::parallel::min_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+// parallel max_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_select_element(std::forward<ExecutionPolicy>(policy), first, last, comp,
+                                                [](ForwardIt f, ForwardIt l, Compare & c){ return std::max_element(f, l, c); },
+                                                detail::_select_first_max<ForwardIt, Compare>);
+    }
+    return std::max_element(first, last, comp);
+}
+
+// parallel max_element algorithm
+template< class ExecutionPolicy, class ForwardIt >
+ForwardIt max_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    return ::hadoken::parallel::max_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+// parallel minmax_element algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class Compare >
+std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp ){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_minmax_element(std::forward<ExecutionPolicy>(policy), first, last, comp);
+    }
+    return std::minmax_element(first, last, comp);
+}
+
+// parallel minmax_element algorithm
+template< class ExecutionPolicy, class ForwardIt >
+std::pair<ForwardIt, ForwardIt> minmax_element( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    return ::hadoken::parallel::minmax_element(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_MINMAX_GENERIC_HPP
@@ -45,25 +45,35 @@ namespace parallel{
 
 namespace detail{
 
-
+// return true if at least one element satisfies p
+// every chunk stops as soon as a match has been found by any other chunk
+template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
+inline bool _internal_any_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    cancellation_token found;
+
+    hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&](InputIterator local_first, InputIterator local_end){
+        for_each_block_cancellable(found, std::distance(first, local_first), local_first, local_end,
+                                   [&](std::size_t offset, InputIterator block_first, InputIterator block_end){
+            (void) offset;
+            if(std::any_of(block_first, block_end, p)){
+                found.cancel();
+            }
+        });
+    });
+    return found.is_cancelled();
+}
 
 } // detail
 
 
 template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool all_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
+    using reference = typename std::iterator_traits<InputIterator>::reference;
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(true);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::all_of(local_first, local_end, p);
-
-            if(local_res == false){
-                res.store(false);
-            }
+        return ! detail::_internal_any_of(std::forward<ExecutionPolicy>(policy), first, last, [&p](reference v){
+            return ! p(v);
         });
-        return res.load();
     }else{
         return std::all_of(first, last, p);
     }
@@ -74,16 +84,7 @@ template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool any_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(false);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::any_of(local_first, local_end, p);
-
-            if(local_res == true){
-                res.store(true);
-            }
-        });
-        return res.load();
+        return detail::_internal_any_of(std::forward<ExecutionPolicy>(policy), first, last, p);
     }else{
         return std::any_of(first, last, p);
     }
@@ -96,16 +97,7 @@ template< class ExecutionPolicy, class InputIterator, class UnaryPredicate >
 inline bool none_of( ExecutionPolicy&& policy, InputIterator first, InputIterator last, UnaryPredicate p ){
 
     if(detail::is_parallel_policy(policy)){
-        std::atomic<bool>  res(true);
-
-        hadoken::parallel::for_range(std::forward<ExecutionPolicy>(policy), first, last, [&res, &p](InputIterator local_first, InputIterator local_end){
-            const bool local_res = std::none_of(local_first, local_end, p);
-
-            if(local_res == false){
-                res.store(false);
-            }
-        });
-        return res.load();
+        return ! detail::_internal_any_of(std::forward<ExecutionPolicy>(policy), first, last, p);
     }else{
         return std::none_of(first, last, p);
     }
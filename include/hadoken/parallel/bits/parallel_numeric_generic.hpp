@@ -33,12 +33,16 @@
 #include <algorithm>
 #include <cmath>
 #include <mutex>
+#include <numeric>
+#include <tuple>
+#include <vector>
 
 
 #include <hadoken/thread/spinlock.hpp>
 
 #include <hadoken/parallel/algorithm.hpp>
 #include "parallel_generic_utils.hpp"
+#include "parallel_vector_generic.hpp"
 
 
 namespace hadoken{
@@ -98,10 +102,15 @@ OutputIt _internal_inclusive_scan( ExecutionPolicy&& policy,
     
 
     // post sum of each chunk partial sum
-    for_range(policy, d_first, d_end, [&](InputIt local_first, InputIt local_last){
+    // the chunks of this pass can differ from the first one, ( e.g. aligned on the output )
+    // the elements of the first chunk are skipped
+    for_range(policy, d_first, d_end, [&](OutputIt local_first, OutputIt local_last){
         
-        if(local_first < std::get<0>(limits_vec[0]))
+        if(local_last <= std::get<0>(limits_vec[0]))
             return;
+
+        if(local_first < std::get<0>(limits_vec[0]))
+            local_first = std::get<0>(limits_vec[0]);
         
         value_type val = std::get<1>(limits_vec[0]);
         
@@ -110,7 +119,7 @@ OutputIt _internal_inclusive_scan( ExecutionPolicy&& policy,
         
         
         while(local_first < local_last){
-            while(local_first >= std::get<0>(*limit_it) && limit_it < limits_vec.end()){
+            while(limit_it < limits_vec.end() && local_first >= std::get<0>(*limit_it)){
                 val = binary_op(val, std::get<1>(*limit_it));
                 limit_it++;
             }
@@ -124,6 +133,53 @@ OutputIt _internal_inclusive_scan( ExecutionPolicy&& policy,
 
 }
 
+
+// pairwise combination of the values of a non empty sequence of (offset, value):
+// ((v0 + v1) + (v2 + v3)) + ((v4 + v5) + v6), the order only depends on the number of values
+template<typename OffsetValue, typename BinaryOperation>
+typename OffsetValue::second_type _tree_combine(std::vector<OffsetValue> & values, BinaryOperation & binary_op){
+    for(std::size_t stride = 1; stride < values.size(); stride *= 2){
+        for(std::size_t i = 0; i + stride < values.size(); i += 2 * stride){
+            values[i].second = binary_op(values[i].second, values[i + stride].second);
+        }
+    }
+    return values.front().second;
+}
+
+
+template< class ExecutionPolicy, class InputIt, class T, class BinaryOperation >
+T _internal_reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init, BinaryOperation binary_op){
+    using offset_value = std::pair<std::size_t, T>;
+
+    std::vector<offset_value> partials;
+    hadoken::thread::spin_lock partials_lock;
+    partials.reserve(64);
+
+    for_range(policy, first, last, [&](InputIt local_first, InputIt local_last){
+        if(local_first == local_last){
+            return;
+        }
+
+        const std::size_t offset = std::distance(first, local_first);
+        T local_res = _chunk_reduce<T>(use_simd_reduce<ExecutionPolicy, InputIt, T, BinaryOperation>(),
+                                       local_first, local_last, binary_op);
+
+        std::lock_guard<hadoken::thread::spin_lock> _l(partials_lock);
+        partials.emplace_back(offset, std::move(local_res));
+    });
+
+    if(partials.empty()){
+        return init;
+    }
+
+    // combine the partial results in a fixed tree order over the chunks of the range
+    std::sort(partials.begin(), partials.end(), [](const offset_value & v1, const offset_value & v2){
+        return v1.first < v2.first;
+    });
+
+    return binary_op(init, _tree_combine(partials, binary_op));
+}
+
 } // detail
 
 // inclusive scan algorithm
@@ -148,6 +204,30 @@ OutputIt inclusive_scan( ExecutionPolicy&& policy,
     return std::partial_sum(first, last, d_first, binary_op);
 }
 
+
+// reduce algorithm
+template< class ExecutionPolicy, class InputIt >
+typename std::iterator_traits<InputIt>::value_type reduce( ExecutionPolicy&& policy, InputIt first, InputIt last){
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
+    return reduce(std::forward<ExecutionPolicy>(policy), first, last, value_type(), std::plus<value_type>());
+}
+
+// reduce algorithm with initial value
+template< class ExecutionPolicy, class InputIt, class T >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init){
+    return reduce(std::forward<ExecutionPolicy>(policy), first, last, init, std::plus<T>());
+}
+
+// reduce algorithm with initial value and binary operation
+template< class ExecutionPolicy, class InputIt, class T, class BinaryOperation >
+T reduce( ExecutionPolicy&& policy, InputIt first, InputIt last, T init, BinaryOperation binary_op){
+    if(detail::is_parallel_policy(policy)){
+        return detail::_internal_reduce(std::forward<ExecutionPolicy>(policy), first, last, init, binary_op);
+    }
+    return std::accumulate(first, last, init, binary_op);
+}
+
 } //parallel
 
 } // hadoken
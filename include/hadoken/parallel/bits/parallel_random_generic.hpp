@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_RANDOM_GENERIC_HPP
+#define PARALLEL_RANDOM_GENERIC_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <hadoken/random/random_derivate.hpp>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_copy_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+/// number of elements generated by each random stream of generate_random
+///
+/// part of the definition of the generated sequences:
+/// changing it changes the output of generate_random
+constexpr std::size_t random_block_size = 4096;
+
+
+// distributions with a bulk generate(engine, first, last) member, e.g hadoken::normal_distribution
+template<typename Distribution, typename Engine, typename Iterator, typename Enable = void>
+struct has_bulk_generate : std::false_type {};
+
+template<typename Distribution, typename Engine, typename Iterator>
+struct has_bulk_generate<Distribution, Engine, Iterator,
+        decltype(void(std::declval<Distribution &>().generate(std::declval<Engine &>(), std::declval<Iterator>(), std::declval<Iterator>())))>
+    : std::true_type {};
+
+
+template<typename Iterator, typename Engine, typename Distribution>
+inline void _generate_random_values(Iterator first, Iterator last, Engine & engine, Distribution & dist, std::true_type){
+    dist.generate(engine, first, last);
+}
+
+template<typename Iterator, typename Engine, typename Distribution>
+inline void _generate_random_values(Iterator first, Iterator last, Engine & engine, Distribution & dist, std::false_type){
+    for(; first != last; ++first){
+        *first = dist(engine);
+    }
+}
+
+
+// fill a block with its own stream, derivated from engine with the block id
+template<typename Iterator, typename Engine, typename Distribution>
+inline void _generate_random_block(Iterator first, Iterator last, const Engine & engine,
+                                   const Distribution & dist, std::size_t block_id){
+    Engine block_engine = random_engine_derivate(engine, static_cast<typename Engine::result_type>(block_id));
+    Distribution block_dist(dist);
+
+    _generate_random_values(first, last, block_engine, block_dist, has_bulk_generate<Distribution, Engine, Iterator>());
+}
+
+
+} // detail
+
+
+// generate_random algorithm
+template< class ExecutionPolicy, class ForwardIt, class Engine, class Distribution >
+void generate_random( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Engine & engine, const Distribution & dist ){
+    const std::size_t n_elems = std::distance(first, last);
+    const detail::block_decomposition blocks(n_elems, execution_parameters().with(grain(detail::random_block_size)));
+
+    detail::_for_each_block(policy, blocks, [&](std::size_t block_id){
+        detail::_generate_random_block(detail::get_end_iterator(first, blocks.block_first(block_id)),
+                                       detail::get_end_iterator(first, blocks.block_last(block_id)),
+                                       engine, dist, block_id);
+    });
+
+    // next calls get independent streams
+    (void) engine();
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_RANDOM_GENERIC_HPP
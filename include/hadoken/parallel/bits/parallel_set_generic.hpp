@@ -0,0 +1,435 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_SET_GENERIC_HPP
+#define PARALLEL_SET_GENERIC_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include "parallel_generic_utils.hpp"
+#include "parallel_copy_generic.hpp"
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+template<typename Iterator>
+struct is_random_access_iterator : public std::is_base_of<std::random_access_iterator_tag,
+                                                          typename std::iterator_traits<Iterator>::iterator_category>{};
+
+
+/// output iterator counting the assigned elements
+class count_output_iterator{
+public:
+    typedef std::output_iterator_tag iterator_category;
+    typedef void value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef void pointer;
+    typedef void reference;
+
+    inline count_output_iterator() : _count(0){}
+
+    inline count_output_iterator & operator*(){
+        return *this;
+    }
+
+    template<typename T>
+    inline count_output_iterator & operator=(const T &){
+        ++_count;
+        return *this;
+    }
+
+    inline count_output_iterator & operator++(){
+        return *this;
+    }
+
+    inline count_output_iterator & operator++(int){
+        return *this;
+    }
+
+    inline std::size_t count() const{
+        return _count;
+    }
+
+private:
+    std::size_t _count;
+};
+
+
+// merge order of the set algorithms: on equivalence, the element of the first range comes first
+template<typename Compare>
+struct _merge_take_first{
+    Compare & comp;
+
+    template<typename T1, typename T2>
+    inline bool operator()(const T1 & a, const T2 & b) const{
+        return !comp(b, a);
+    }
+};
+
+// merge order of the lower_bound searches: a query comes before the equivalent elements
+template<typename Compare>
+struct _merge_take_less{
+    Compare & comp;
+
+    template<typename T1, typename T2>
+    inline bool operator()(const T1 & a, const T2 & q) const{
+        return comp(a, q);
+    }
+};
+
+
+/// merge path search: number of elements of a among the first diag elements of the
+/// merge of a and b, where a[i] comes before b[j] if take_a(a[i], b[j])
+template<typename RandomIt1, typename RandomIt2, typename TakeFirst>
+inline std::size_t _merge_path(RandomIt1 a, std::size_t na, RandomIt2 b, std::size_t nb,
+                               std::size_t diag, const TakeFirst & take_a){
+    std::size_t lo = (diag > nb) ? (diag - nb) : 0, hi = std::min(diag, na);
+    while(lo < hi){
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if(take_a(a[mid], b[diag - mid - 1])){
+            lo = mid + 1;
+        }else{
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+/// lower bound of value in [first, first + pos], knowing that first[pos] is not less than value:
+/// galloping backward from pos, the cost is logarithmic in the distance to the result
+template<typename RandomIt, typename T, typename Compare>
+inline std::size_t _gallop_lower_bound_backward(RandomIt first, std::size_t pos, const T & value, Compare & comp){
+    std::size_t hi = pos, step = 1;
+    while(hi > 0){
+        const std::size_t probe = hi - std::min(step, hi);
+        if(comp(first[probe], value)){
+            return std::distance(first, std::lower_bound(first + probe + 1, first + hi, value, comp));
+        }
+        hi = probe;
+        step *= 2;
+    }
+    return 0;
+}
+
+
+/// lower bound of value in [first + pos, first + last_pos], knowing that first[pos - 1] is less than value:
+/// galloping forward from pos, the cost is logarithmic in the distance to the result
+template<typename RandomIt, typename T, typename Compare>
+inline std::size_t _gallop_lower_bound_forward(RandomIt first, std::size_t pos, std::size_t last_pos,
+                                               const T & value, Compare & comp){
+    std::size_t lo = pos, step = 1;
+    while(lo < last_pos){
+        const std::size_t probe = lo + std::min(step, last_pos - lo) - 1;
+        if(comp(first[probe], value) == false){
+            return std::distance(first, std::lower_bound(first + lo, first + probe, value, comp));
+        }
+        lo = probe + 1;
+        step *= 2;
+    }
+    return last_pos;
+}
+
+
+/// split of two sorted ranges for the set algorithms, near the diagonal diag of their merge path
+///
+/// the split is snapped on the first element of an equal value run in both ranges:
+/// the runs of equivalent elements are never cut, each side of the split can be processed independently
+template<typename RandomIt1, typename RandomIt2, typename Compare>
+inline std::pair<std::size_t, std::size_t> _set_split(RandomIt1 first1, std::size_t n1, RandomIt2 first2, std::size_t n2,
+                                                       std::size_t diag, Compare & comp){
+    std::size_t i = _merge_path(first1, n1, first2, n2, diag, _merge_take_first<Compare>{ comp });
+    std::size_t j = diag - i;
+
+    if(i < n1 && (j == n2 || comp(first2[j], first1[i]) == false)){
+        const auto & key = first1[i];
+        j = _gallop_lower_bound_backward(first2, j, key, comp);
+        i = _gallop_lower_bound_backward(first1, i, key, comp);
+    }else if(j < n2){
+        const auto & key = first2[j];
+        i = _gallop_lower_bound_backward(first1, i, key, comp);
+        j = _gallop_lower_bound_backward(first2, j, key, comp);
+    }
+    return std::make_pair(i, j);
+}
+
+
+struct _set_intersection_op{
+    template<typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+    inline OutputIt operator()(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare & comp) const{
+        return std::set_intersection(first1, last1, first2, last2, d_first, comp);
+    }
+};
+
+struct _set_union_op{
+    template<typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+    inline OutputIt operator()(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare & comp) const{
+        return std::set_union(first1, last1, first2, last2, d_first, comp);
+    }
+};
+
+struct _set_difference_op{
+    template<typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+    inline OutputIt operator()(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare & comp) const{
+        return std::set_difference(first1, last1, first2, last2, d_first, comp);
+    }
+};
+
+
+template<typename Iterator1, typename Iterator2>
+struct is_random_access_pair : public std::integral_constant<bool,
+        is_random_access_iterator<Iterator1>::value && is_random_access_iterator<Iterator2>::value>{};
+
+
+// true if the merge path version should be used
+template<typename ExecutionPolicy>
+inline bool _use_parallel_merge_path(const ExecutionPolicy & policy, std::size_t n_elems){
+    return is_parallel_policy(policy) && n_elems >= get_execution_parameters(policy).threshold();
+}
+
+
+/// set algorithm over merge path blocks:
+/// the blocks are split on equal value runs, their output size is counted
+/// then each block writes at its offset, the output must be a forward iterator ( std::true_type )
+template<typename ExecutionPolicy, typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare, typename SetOperation>
+inline OutputIt _parallel_set_operation(const ExecutionPolicy & policy, RandomIt1 first1, RandomIt1 last1,
+                                        RandomIt2 first2, RandomIt2 last2, OutputIt d_first,
+                                        Compare & comp, const SetOperation & op, std::true_type){
+    const std::size_t n1 = std::distance(first1, last1), n2 = std::distance(first2, last2);
+    const block_decomposition blocks(n1 + n2, get_execution_parameters(policy));
+
+    std::vector<std::pair<std::size_t, std::size_t> > splits(blocks.size() + 1, std::make_pair(n1, n2));
+    std::vector<std::size_t> offsets(blocks.size() + 1, 0);
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        const std::pair<std::size_t, std::size_t> split_first = _set_split(first1, n1, first2, n2, blocks.block_first(block_id), comp);
+        const std::pair<std::size_t, std::size_t> split_last = _set_split(first1, n1, first2, n2, blocks.block_last(block_id), comp);
+        splits[block_id] = split_first;
+
+        offsets[block_id + 1] = op(first1 + split_first.first, first1 + split_last.first,
+                                   first2 + split_first.second, first2 + split_last.second,
+                                   count_output_iterator(), comp).count();
+    });
+
+    ::hadoken::parallel::inclusive_scan(_block_policy(policy), offsets.begin() + 1, offsets.end(), offsets.begin() + 1);
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        op(first1 + splits[block_id].first, first1 + splits[block_id + 1].first,
+           first2 + splits[block_id].second, first2 + splits[block_id + 1].second,
+           get_end_iterator(d_first, offsets[block_id]), comp);
+    });
+
+    return get_end_iterator(d_first, offsets.back());
+}
+
+template<typename ExecutionPolicy, typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare, typename SetOperation>
+inline OutputIt _parallel_set_operation(const ExecutionPolicy &, RandomIt1 first1, RandomIt1 last1,
+                                        RandomIt2 first2, RandomIt2 last2, OutputIt d_first,
+                                        Compare & comp, const SetOperation & op, std::false_type){
+    return op(first1, last1, first2, last2, d_first, comp);
+}
+
+
+template<typename ExecutionPolicy, typename InputIt1, typename InputIt2, typename OutputIt, typename Compare, typename SetOperation>
+inline OutputIt _set_operation(const ExecutionPolicy & policy, InputIt1 first1, InputIt1 last1,
+                               InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                               Compare & comp, const SetOperation & op, std::true_type){
+    if(_use_parallel_merge_path(policy, std::distance(first1, last1) + std::distance(first2, last2))){
+        return _parallel_set_operation(policy, first1, last1, first2, last2, d_first, comp, op, is_forward_iterator<OutputIt>());
+    }
+    return op(first1, last1, first2, last2, d_first, comp);
+}
+
+template<typename ExecutionPolicy, typename InputIt1, typename InputIt2, typename OutputIt, typename Compare, typename SetOperation>
+inline OutputIt _set_operation(const ExecutionPolicy &, InputIt1 first1, InputIt1 last1,
+                               InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                               Compare & comp, const SetOperation & op, std::false_type){
+    return op(first1, last1, first2, last2, d_first, comp);
+}
+
+
+/// lower bounds of the sorted queries [q_first, q_first + n_queries) in [first, first + n_elems),
+/// in a single merge walk from the position pos
+template<typename RandomIt, typename QueryIt, typename OutputIt, typename Compare>
+inline OutputIt _lower_bound_walk(RandomIt first, std::size_t pos, std::size_t last_pos,
+                                  QueryIt q_first, std::size_t n_queries, OutputIt d_first, Compare & comp){
+    for(std::size_t q = 0; q < n_queries; ++q, ++q_first, ++d_first){
+        pos = _gallop_lower_bound_forward(first, pos, last_pos, *q_first, comp);
+        *d_first = first + pos;
+    }
+    return d_first;
+}
+
+
+/// lower_bound_n over merge path blocks of the range and of the queries:
+/// the results of the queries of a block are inside the range part of the block,
+/// the output must be a forward iterator ( std::true_type )
+template<typename ExecutionPolicy, typename RandomIt, typename QueryIt, typename OutputIt, typename Compare>
+inline OutputIt _parallel_lower_bound_n(const ExecutionPolicy & policy, RandomIt first, std::size_t n_elems,
+                                        QueryIt q_first, std::size_t n_queries, OutputIt d_first, Compare & comp, std::true_type){
+    const block_decomposition blocks(n_elems + n_queries, get_execution_parameters(policy));
+    const _merge_take_less<Compare> take_less{ comp };
+
+    _for_each_block(policy, blocks, [&](std::size_t block_id){
+        const std::size_t diag_first = blocks.block_first(block_id), diag_last = blocks.block_last(block_id);
+        const std::size_t i_first = _merge_path(first, n_elems, q_first, n_queries, diag_first, take_less);
+        const std::size_t i_last = _merge_path(first, n_elems, q_first, n_queries, diag_last, take_less);
+        const std::size_t q_begin = diag_first - i_first, q_end = diag_last - i_last;
+
+        _lower_bound_walk(first, i_first, i_last, q_first + q_begin, q_end - q_begin,
+                          get_end_iterator(d_first, q_begin), comp);
+    });
+    return get_end_iterator(d_first, n_queries);
+}
+
+template<typename ExecutionPolicy, typename RandomIt, typename QueryIt, typename OutputIt, typename Compare>
+inline OutputIt _parallel_lower_bound_n(const ExecutionPolicy &, RandomIt first, std::size_t n_elems,
+                                        QueryIt q_first, std::size_t n_queries, OutputIt d_first, Compare & comp, std::false_type){
+    return _lower_bound_walk(first, 0, n_elems, q_first, n_queries, d_first, comp);
+}
+
+
+template<typename ExecutionPolicy, typename RandomIt, typename QueryIt, typename OutputIt, typename Compare>
+inline OutputIt _lower_bound_n(const ExecutionPolicy & policy, RandomIt first, RandomIt last,
+                               QueryIt q_first, std::size_t n_queries, OutputIt d_first, Compare & comp, std::true_type){
+    const std::size_t n_elems = std::distance(first, last);
+
+    if(_use_parallel_merge_path(policy, n_elems + n_queries)){
+        return _parallel_lower_bound_n(policy, first, n_elems, q_first, n_queries, d_first, comp, is_forward_iterator<OutputIt>());
+    }
+    return _lower_bound_walk(first, 0, n_elems, q_first, n_queries, d_first, comp);
+}
+
+template<typename ExecutionPolicy, typename ForwardIt, typename QueryIt, typename OutputIt, typename Compare>
+inline OutputIt _lower_bound_n(const ExecutionPolicy &, ForwardIt first, ForwardIt last,
+                               QueryIt q_first, std::size_t n_queries, OutputIt d_first, Compare & comp, std::false_type){
+    for(std::size_t q = 0; q < n_queries; ++q, ++q_first, ++d_first){
+        first = std::lower_bound(first, last, *q_first, comp);
+        *d_first = first;
+    }
+    return d_first;
+}
+
+
+} // detail
+
+
+
+// parallel set_intersection algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_intersection( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                           InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp ){
+    return detail::_set_operation(policy, first1, last1, first2, last2, d_first, comp, detail::_set_intersection_op(),
+                                  detail::is_random_access_pair<InputIt1, InputIt2>());
+}
+
+
+// parallel set_intersection algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_intersection( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                           InputIt2 first2, InputIt2 last2, OutputIt d_first ){
+    using value_type = typename std::iterator_traits<InputIt1>::value_type;
+    return ::hadoken::parallel::set_intersection(std::forward<ExecutionPolicy>(policy), first1, last1, first2, last2, d_first, std::less<value_type>());
+}
+
+
+// parallel set_union algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_union( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                    InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp ){
+    return detail::_set_operation(policy, first1, last1, first2, last2, d_first, comp, detail::_set_union_op(),
+                                  detail::is_random_access_pair<InputIt1, InputIt2>());
+}
+
+
+// parallel set_union algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_union( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                    InputIt2 first2, InputIt2 last2, OutputIt d_first ){
+    using value_type = typename std::iterator_traits<InputIt1>::value_type;
+    return ::hadoken::parallel::set_union(std::forward<ExecutionPolicy>(policy), first1, last1, first2, last2, d_first, std::less<value_type>());
+}
+
+
+// parallel set_difference algorithm with comparator
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt, class Compare >
+OutputIt set_difference( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                         InputIt2 first2, InputIt2 last2, OutputIt d_first, Compare comp ){
+    return detail::_set_operation(policy, first1, last1, first2, last2, d_first, comp, detail::_set_difference_op(),
+                                  detail::is_random_access_pair<InputIt1, InputIt2>());
+}
+
+
+// parallel set_difference algorithm
+template< class ExecutionPolicy, class InputIt1, class InputIt2, class OutputIt >
+OutputIt set_difference( ExecutionPolicy&& policy, InputIt1 first1, InputIt1 last1,
+                         InputIt2 first2, InputIt2 last2, OutputIt d_first ){
+    using value_type = typename std::iterator_traits<InputIt1>::value_type;
+    return ::hadoken::parallel::set_difference(std::forward<ExecutionPolicy>(policy), first1, last1, first2, last2, d_first, std::less<value_type>());
+}
+
+
+// parallel lower_bound_n algorithm with comparator
+template< class ExecutionPolicy, class ForwardIt, class InputIt, class Size, class OutputIt, class Compare >
+OutputIt lower_bound_n( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        InputIt q_first, Size n_queries, OutputIt d_first, Compare comp ){
+    if(n_queries <= 0){
+        return d_first;
+    }
+    return detail::_lower_bound_n(policy, first, last, q_first, static_cast<std::size_t>(n_queries), d_first, comp,
+                                  detail::is_random_access_pair<ForwardIt, InputIt>());
+}
+
+
+// parallel lower_bound_n algorithm
+template< class ExecutionPolicy, class ForwardIt, class InputIt, class Size, class OutputIt >
+OutputIt lower_bound_n( ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        InputIt q_first, Size n_queries, OutputIt d_first ){
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    return ::hadoken::parallel::lower_bound_n(std::forward<ExecutionPolicy>(policy), first, last, q_first, n_queries, d_first, std::less<value_type>());
+}
+
+
+} //parallel
+
+} // hadoken
+
+#endif // PARALLEL_SET_GENERIC_HPP
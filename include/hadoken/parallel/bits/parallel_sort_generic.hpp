@@ -31,10 +31,15 @@
 
 #include <atomic>
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
 #include <hadoken/parallel/algorithm.hpp>
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_copy_generic.hpp"
 
 
 namespace hadoken{
@@ -46,6 +51,61 @@ namespace parallel{
 namespace detail{
 
 
+/// number of elements of the sample used to select the pivots of nth_element
+constexpr std::size_t nth_element_sample_size = 127;
+
+// pivot value for nth_element: median of regularly spaced samples
+template<typename RandomIt, typename Compare>
+typename std::iterator_traits<RandomIt>::value_type _sample_pivot(RandomIt first, RandomIt last, Compare & comp){
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t n_elems = std::distance(first, last);
+    const std::size_t n_samples = std::min(n_elems, nth_element_sample_size);
+
+    std::vector<value_type> samples;
+    samples.reserve(n_samples);
+    for(std::size_t i = 0; i < n_samples; ++i){
+        samples.push_back(first[(i * n_elems) / n_samples]);
+    }
+
+    auto median = samples.begin() + n_samples / 2;
+    std::nth_element(samples.begin(), median, samples.end(), comp);
+    return *median;
+}
+
+
+// nth_element by successive three way parallel partitions around a sampled pivot
+template< class ExecutionPolicy, class RandomIt, class Compare >
+void _internal_nth_element( ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last, Compare & comp){
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    using reference = typename std::iterator_traits<RandomIt>::reference;
+
+    const std::size_t sequential_limit = std::max<std::size_t>(2 * default_block_size,
+                                                               get_execution_parameters(policy).threshold());
+
+    while(static_cast<std::size_t>(std::distance(first, last)) > sequential_limit){
+        const value_type pivot = _sample_pivot(first, last, comp);
+
+        // [first, lower) < pivot, [lower, upper) == pivot, [upper, last) > pivot
+        RandomIt lower = ::hadoken::parallel::partition(policy, first, last, [&](reference v){
+            return comp(v, pivot);
+        });
+        RandomIt upper = ::hadoken::parallel::partition(policy, lower, last, [&](reference v){
+            return !comp(pivot, v);
+        });
+
+        if(nth < lower){
+            last = lower;
+        }else if(nth < upper){
+            return;
+        }else{
+            first = upper;
+        }
+    }
+
+    std::nth_element(first, nth, last, comp);
+}
+
 
 } // detail
 
@@ -66,6 +126,52 @@ void sort( ExecutionPolicy&& policy, RandomIt first, RandomIt last, Compare comp
 }
 
 
+// nth_element algorithm with comparator
+template< class ExecutionPolicy, class RandomIt, class Compare >
+void nth_element( ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last, Compare comp ){
+    if(nth == last){
+        return;
+    }
+
+    if(detail::is_parallel_policy(policy)){
+        detail::_internal_nth_element(std::forward<ExecutionPolicy>(policy), first, nth, last, comp);
+        return;
+    }
+    std::nth_element(first, nth, last, comp);
+}
+
+// nth_element algorithm
+template< class ExecutionPolicy, class RandomIt >
+void nth_element( ExecutionPolicy&& policy, RandomIt first, RandomIt nth, RandomIt last ){
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    ::hadoken::parallel::nth_element(std::forward<ExecutionPolicy>(policy), first, nth, last, std::less<value_type>());
+}
+
+
+// partial_sort algorithm with comparator
+template< class ExecutionPolicy, class RandomIt, class Compare >
+void partial_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last, Compare comp ){
+    if(detail::is_parallel_policy(policy)){
+        if(first == middle){
+            return;
+        }
+
+        // select the middle - first smallest elements, then sort them
+        ::hadoken::parallel::nth_element(policy, first, middle - 1, last, comp);
+        ::hadoken::parallel::sort(policy, first, middle - 1, comp);
+        return;
+    }
+    std::partial_sort(first, middle, last, comp);
+}
+
+// partial_sort algorithm
+template< class ExecutionPolicy, class RandomIt >
+void partial_sort( ExecutionPolicy&& policy, RandomIt first, RandomIt middle, RandomIt last ){
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    ::hadoken::parallel::partial_sort(std::forward<ExecutionPolicy>(policy), first, middle, last, std::less<value_type>());
+}
+
+
 } //parallel
 
 } // hadoken
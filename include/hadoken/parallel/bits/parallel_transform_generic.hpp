@@ -31,6 +31,7 @@
 
 #include <tuple>
 #include <algorithm>
+#include <utility>
 
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp>
@@ -39,6 +40,7 @@
 
 
 #include "parallel_generic_utils.hpp"
+#include "parallel_vector_generic.hpp"
 
 
 namespace hadoken{
@@ -46,26 +48,65 @@ namespace hadoken{
 
 namespace parallel{
 
+
+namespace detail{
+
+
+///
+/// \brief composition of element wise functions, applied from left to right
+///
+/// function_chain<F1, F2, F3>(f1, f2, f3)(v) == f3(f2(f1(v)))
+///
+template<typename... Functions>
+class function_chain;
+
+template<typename Function>
+class function_chain<Function>{
+public:
+    inline explicit function_chain(Function fun) : _fun(std::move(fun)){}
+
+    template<typename Value>
+    inline auto operator()(Value && v) const -> decltype(std::declval<const Function &>()(std::forward<Value>(v))){
+        return _fun(std::forward<Value>(v));
+    }
+
+private:
+    Function _fun;
+};
+
+template<typename Function, typename... Functions>
+class function_chain<Function, Functions...>{
+public:
+    inline explicit function_chain(Function fun, Functions... funs) : _fun(std::move(fun)), _next(std::move(funs)...){}
+
+    template<typename Value>
+    inline auto operator()(Value && v) const
+        -> decltype(std::declval<const function_chain<Functions...> &>()(std::declval<const Function &>()(std::forward<Value>(v)))){
+        return _next(_fun(std::forward<Value>(v)));
+    }
+
+private:
+    Function _fun;
+    function_chain<Functions...> _next;
+};
+
+
+} // detail
+
+
 template< class ExecutionPolicy, class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation >
 OutputIterator transform( ExecutionPolicy&& policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
                     OutputIterator d_first, BinaryOperation binary_op ){
     if(detail::is_parallel_policy(policy)){
-        InputIterator1 d_last = d_first;
-
-        hadoken::parallel::for_range(policy, first1, last1, [&](InputIterator1 local_begin, InputIterator2 local_end){
+        hadoken::parallel::for_range(policy, first1, last1, [&](InputIterator1 local_begin, InputIterator1 local_end){
            const std::size_t pos = std::distance(first1, local_begin);
 
-           InputIterator2 local_first2 = first2;
-           std::advance(local_first2, pos);
-           OutputIterator d_local_first = d_first;
-           std::advance(d_local_first, pos);
-
-           std::transform(local_begin, local_end, local_first2, d_local_first, binary_op);
-
+           detail::_chunk_transform(detail::use_simd_path<ExecutionPolicy, InputIterator1, InputIterator2, OutputIterator>(),
+                                    local_begin, local_end, detail::get_end_iterator(first2, pos),
+                                    detail::get_end_iterator(d_first, pos), binary_op);
         });
 
-        std::advance(d_last, std::distance(first1, last1));
-        return d_last;
+        return detail::get_end_iterator(d_first, std::distance(first1, last1));
     } else{
         return std::transform(first1, last1, first2, d_first, binary_op);
     }
@@ -77,13 +118,32 @@ OutputIterator transform( ExecutionPolicy&& policy, InputIterator1 first1, Input
 template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryOperation >
 OutputIt transform( ExecutionPolicy&& policy, InputIt first1, InputIt last1, OutputIt d_first,
                     UnaryOperation unary_op ){
-    using value_type = typename std::iterator_traits<InputIt>::value_type;
-    return transform(policy, first1, last1, first1, d_first, [&unary_op](const value_type & v1, const value_type & v2){
-        (void) v2;
-        return unary_op(v1);
-    });
+    if(detail::is_parallel_policy(policy)){
+        hadoken::parallel::for_range(policy, first1, last1, [&](InputIt local_begin, InputIt local_end){
+           OutputIt d_local_first = d_first;
+           std::advance(d_local_first, std::distance(first1, local_begin));
+
+           detail::_chunk_transform(detail::use_simd_path<ExecutionPolicy, InputIt, OutputIt>(),
+                                    local_begin, local_end, d_local_first, unary_op);
+        });
+
+        std::advance(d_first, std::distance(first1, last1));
+        return d_first;
+    } else{
+        return std::transform(first1, last1, d_first, unary_op);
+    }
 }
 
+
+
+template< class ExecutionPolicy, class InputIt, class OutputIt, class UnaryOperation, class... UnaryOperations >
+OutputIt transform_n( ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt d_first,
+                      UnaryOperation op, UnaryOperations... ops ){
+    const detail::function_chain<UnaryOperation, UnaryOperations...> chain(std::move(op), std::move(ops)...);
+    return ::hadoken::parallel::transform(std::forward<ExecutionPolicy>(policy), first, last, d_first, chain);
+}
+
+
 } //parallel
 
 } // hadoken
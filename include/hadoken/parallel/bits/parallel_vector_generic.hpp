@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef PARALLEL_VECTOR_GENERIC_HPP
+#define PARALLEL_VECTOR_GENERIC_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+
+#include <hadoken/parallel/algorithm.hpp>
+
+
+///
+/// vectorisation hints for the chunk bodies of the par_vec policy
+///
+/// the loops are annotated with '#pragma omp simd' when OpenMP 4.0 is enabled,
+/// HADOKEN_PARALLEL_USE_OMP_SIMD can be defined manually when compiling with -fopenmp-simd
+///
+#if (defined _OPENMP) && (_OPENMP >= 201307) && !(defined HADOKEN_PARALLEL_USE_OMP_SIMD)
+#define HADOKEN_PARALLEL_USE_OMP_SIMD
+#endif
+
+#define HADOKEN_PARALLEL_PRAGMA_STR(x) #x
+
+#ifdef HADOKEN_PARALLEL_USE_OMP_SIMD
+#define HADOKEN_PARALLEL_OMP_SIMD _Pragma("omp simd")
+#define HADOKEN_PARALLEL_OMP_SIMD_REDUCTION(op, var) _Pragma(HADOKEN_PARALLEL_PRAGMA_STR(omp simd reduction(op:var)))
+#else
+#define HADOKEN_PARALLEL_OMP_SIMD
+#define HADOKEN_PARALLEL_OMP_SIMD_REDUCTION(op, var)
+#endif
+
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+namespace detail{
+
+
+template<typename Iterator>
+struct is_simd_iterator : public std::integral_constant<bool,
+        std::is_same<typename std::iterator_traits<Iterator>::iterator_category, std::random_access_iterator_tag>::value
+        && std::is_arithmetic<typename std::iterator_traits<Iterator>::value_type>::value >{};
+
+/// true when the chunk bodies can use the vector kernels:
+/// par_vec policy over random access ranges of arithmetic types
+template<typename ExecPolicy, typename... Iterators>
+struct use_simd_path;
+
+template<typename ExecPolicy>
+struct use_simd_path<ExecPolicy> : public is_vector_execution_policy<typename std::decay<ExecPolicy>::type>{};
+
+template<typename ExecPolicy, typename Iterator, typename... Iterators>
+struct use_simd_path<ExecPolicy, Iterator, Iterators...> : public std::integral_constant<bool,
+        is_simd_iterator<Iterator>::value && use_simd_path<ExecPolicy, Iterators...>::value >{};
+
+
+
+// count_if kernels
+template<typename Iterator, typename UnaryPredicate>
+inline typename std::iterator_traits<Iterator>::difference_type
+    _chunk_count_if(std::false_type, Iterator first, Iterator last, UnaryPredicate & p){
+    return std::count_if(first, last, p);
+}
+
+template<typename Iterator, typename UnaryPredicate>
+inline typename std::iterator_traits<Iterator>::difference_type
+    _chunk_count_if(std::true_type, Iterator first, Iterator last, UnaryPredicate & p){
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    const difference_type n = last - first;
+    difference_type res = 0;
+
+    HADOKEN_PARALLEL_OMP_SIMD_REDUCTION(+, res)
+    for(difference_type i = 0; i < n; ++i){
+        res += (p(first[i]) ? 1 : 0);
+    }
+    return res;
+}
+
+
+// fill kernels
+template<typename Iterator, typename T>
+inline void _chunk_fill(std::false_type, Iterator first, Iterator last, const T & val){
+    std::fill(first, last, val);
+}
+
+template<typename Iterator, typename T>
+inline void _chunk_fill(std::true_type, Iterator first, Iterator last, const T & val){
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    const difference_type n = last - first;
+    const value_type v = static_cast<value_type>(val);
+
+    HADOKEN_PARALLEL_OMP_SIMD
+    for(difference_type i = 0; i < n; ++i){
+        first[i] = v;
+    }
+}
+
+
+// unary transform kernels
+template<typename InputIt, typename OutputIt, typename UnaryOperation>
+inline void _chunk_transform(std::false_type, InputIt first, InputIt last, OutputIt d_first, UnaryOperation & op){
+    std::transform(first, last, d_first, op);
+}
+
+template<typename InputIt, typename OutputIt, typename UnaryOperation>
+inline void _chunk_transform(std::true_type, InputIt first, InputIt last, OutputIt d_first, UnaryOperation & op){
+    using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+    const difference_type n = last - first;
+
+    HADOKEN_PARALLEL_OMP_SIMD
+    for(difference_type i = 0; i < n; ++i){
+        d_first[i] = op(first[i]);
+    }
+}
+
+
+// binary transform kernels
+template<typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryOperation>
+inline void _chunk_transform(std::false_type, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first, BinaryOperation & op){
+    std::transform(first1, last1, first2, d_first, op);
+}
+
+template<typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryOperation>
+inline void _chunk_transform(std::true_type, InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first, BinaryOperation & op){
+    using difference_type = typename std::iterator_traits<InputIt1>::difference_type;
+    const difference_type n = last1 - first1;
+
+    HADOKEN_PARALLEL_OMP_SIMD
+    for(difference_type i = 0; i < n; ++i){
+        d_first[i] = op(first1[i], first2[i]);
+    }
+}
+
+
+// reduce kernels, for non empty ranges
+template<typename T, typename Iterator, typename BinaryOperation>
+inline T _chunk_reduce(std::false_type, Iterator first, Iterator last, BinaryOperation & op){
+    T res = *first;
+    for(++first; first != last; ++first){
+        res = op(res, *first);
+    }
+    return res;
+}
+
+template<typename T, typename Iterator, typename BinaryOperation>
+inline T _chunk_reduce(std::true_type, Iterator first, Iterator last, BinaryOperation & op){
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    (void) op;
+    const difference_type n = last - first;
+    T res = T();
+
+    HADOKEN_PARALLEL_OMP_SIMD_REDUCTION(+, res)
+    for(difference_type i = 0; i < n; ++i){
+        res += first[i];
+    }
+    return res;
+}
+
+/// the vector reduction is only used for additions
+template<typename ExecPolicy, typename Iterator, typename T, typename BinaryOperation>
+struct use_simd_reduce : public std::integral_constant<bool,
+        use_simd_path<ExecPolicy, Iterator>::value
+        && std::is_arithmetic<T>::value
+        && std::is_same<BinaryOperation, std::plus<T> >::value >{};
+
+
+
+} // detail
+
+} // parallel
+
+} // hadoken
+
+#endif // PARALLEL_VECTOR_GENERIC_HPP
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+#ifndef _HADOKEN_TBB_ALGORITHM_BITS_HPP_
+#define _HADOKEN_TBB_ALGORITHM_BITS_HPP_
+
+#include <type_traits>
+#include <iterator>
+#include <stdexcept>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+
+#include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/utility/range.hpp>
+#include <hadoken/parallel/bits/parallel_executor_generic.hpp>
+
+
+#include <hadoken/parallel/bits/parallel_algorithm_generics.hpp>
+#include <hadoken/parallel/bits/parallel_for_loop_generic.hpp>
+#include <hadoken/parallel/bits/parallel_none_any_all_generic.hpp>
+#include <hadoken/parallel/bits/parallel_find_generic.hpp>
+#include <hadoken/parallel/bits/parallel_count_generics.hpp>
+#include <hadoken/parallel/bits/parallel_transform_generic.hpp>
+#include <hadoken/parallel/bits/parallel_sort_generic.hpp>
+#include <hadoken/parallel/bits/parallel_numeric_generic.hpp>
+#include <hadoken/parallel/bits/parallel_copy_generic.hpp>
+#include <hadoken/parallel/bits/parallel_minmax_generic.hpp>
+#include <hadoken/parallel/bits/parallel_random_generic.hpp>
+#include <hadoken/parallel/bits/parallel_set_generic.hpp>
+#include <hadoken/parallel/bits/parallel_histogram_generic.hpp>
+
+namespace hadoken{
+
+
+namespace parallel{
+
+
+class sequential_execution_policy;
+class parallel_execution_policy;
+class parallel_vector_execution_policy;
+
+
+
+namespace detail{
+
+
+/// for_range algorithm on the TBB task scheduler
+///
+/// the chunks of the scheduler are distributed with the static_partitioner
+/// for the static and deterministic schedules and one by one otherwise, TBB >= 2017 is required
+template<typename ExecPolicy, typename Iterator, typename RangeFunction>
+inline void _tbb_for_range(const ExecPolicy & policy, Iterator begin_it, Iterator end_it, RangeFunction & fun){
+    const execution_parameters params = get_execution_parameters(policy);
+    const std::size_t n_elems = std::distance(begin_it, end_it);
+
+    // the chunk functions are never called on an empty range
+    if(n_elems == 0){
+        return;
+    }
+
+    if(n_elems < params.threshold()){
+        fun(begin_it, end_it);
+        return;
+    }
+
+    const chunk_scheduler scheduler(n_elems, tbb::this_task_arena::max_concurrency(), params, make_range_alignment(begin_it, n_elems));
+    const tbb::blocked_range<std::size_t> chunk_ids(0, scheduler.size(), 1);
+
+    auto run_chunks = [&](const tbb::blocked_range<std::size_t> & ids){
+        for(std::size_t chunk_id = ids.begin(); chunk_id < ids.end(); ++chunk_id){
+            std::size_t chunk_first, chunk_last;
+            scheduler.chunk(chunk_id, chunk_first, chunk_last);
+            fun(get_end_iterator(begin_it, chunk_first), get_end_iterator(begin_it, chunk_last));
+        }
+    };
+
+    if(params.schedule() == schedule_type::static_schedule || params.schedule() == schedule_type::deterministic_schedule){
+        tbb::parallel_for(chunk_ids, run_chunks, tbb::static_partitioner());
+    }else{
+        tbb::parallel_for(chunk_ids, run_chunks, tbb::simple_partitioner());
+    }
+}
+
+/// for_range algorithm on the executor bound to the policy
+template<typename Policy, typename Executor, typename Iterator, typename RangeFunction>
+inline void _tbb_for_range(const executor_execution_policy<Policy, Executor> & policy, Iterator begin_it, Iterator end_it, RangeFunction & fun){
+    _executor_for_range(policy, begin_it, end_it, fun);
+}
+
+
+template<typename ExecPolicy, typename Iterator>
+inline void _tbb_for_range_stages(const ExecPolicy & policy, Iterator begin_it, Iterator end_it){
+    (void) policy;
+    (void) begin_it;
+    (void) end_it;
+}
+
+template<typename ExecPolicy, typename Iterator, typename RangeFunction, typename... RangeFunctions>
+inline void _tbb_for_range_stages(const ExecPolicy & policy, Iterator begin_it, Iterator end_it,
+                                  RangeFunction & fun, RangeFunctions & ... funs){
+    if(is_parallel_policy(policy)){
+        _tbb_for_range(policy, begin_it, end_it, fun);
+    }else{
+        fun(begin_it, end_it);
+    }
+    _tbb_for_range_stages(policy, begin_it, end_it, funs...);
+}
+
+
+} // detail
+
+/// for_range_ algorithm
+/// for_range is an extension to for_each where the function
+/// execute on a subrange, instead of a single element
+template<typename ExecPolicy, typename Iterator, typename RangeFunction>
+inline void for_range(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunction fun){
+    if(detail::is_parallel_policy(policy)){
+        detail::_tbb_for_range(policy, begin_it, end_it, fun);
+        return;
+    }
+
+   fun(begin_it, end_it);
+}
+
+
+/// for_range_fused algorithm
+template<typename ExecPolicy, typename Iterator, typename... RangeFunctions>
+inline void for_range_fused(ExecPolicy && policy, Iterator begin_it, Iterator end_it, RangeFunctions... funs){
+    detail::_tbb_for_range_stages(policy, begin_it, end_it, funs...);
+}
+
+
+} // parallel
+
+
+
+} // hadoken
+
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+
+//
+// This work is derivated from the boost.Random123
+// repository accessible here https://github.com/DEShawResearch/Random123-Boost
+//
+//
+
+#ifndef _HADOKEN_RANDOM_ARS_
+#define _HADOKEN_RANDOM_ARS_
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include "impl/aes_impl.hpp"
+#include "impl/counter_block_impl.hpp"
+
+
+///
+///  ars ( Advanced Randomization System ) is a state-less counter base random generator
+///  made of R rounds of AES applied to the counter, with a simplified key schedule:
+///  each round key is the previous one plus the Weyl constants on two 64 bits words
+///
+///   ars has been presented at SC11 in the publication
+///
+/// "Parallel random numbers: as easy as 1, 2, 3".
+///    John K. Salmon, Mark A. Moraes, Ron O. Dror, David E. Shaw" (doi:10.1145/2063384.2063405)
+///
+///  The AES round instructions are used when available at compile time ( see HADOKEN_RANDOM_AESNI ),
+///  with a portable table based implementation of the AES round otherwise.
+///  Both produce the same results than the ars4x32 of the Random123 distribution
+///
+
+namespace hadoken{
+
+
+template <unsigned R=7>
+class ars{
+    BOOST_STATIC_ASSERT( R >= 1 );
+public:
+    typedef boost::array<boost::uint32_t, 4> domain_type;
+    typedef boost::array<boost::uint32_t, 4> range_type;
+    typedef boost::array<boost::uint32_t, 4> key_type;
+    typedef boost::uint32_t                  uint_type;
+
+    ars() : round_keys(){
+        set_key(key_type());
+    }
+    ars(key_type _k) : round_keys(){
+        set_key(_k);
+    }
+
+    ///
+    /// set the key and precompute the R round keys
+    ///
+    void set_key(key_type _k){
+        round_keys[0] = _k;
+        for(std::size_t r = 1; r <= R; ++r){
+            round_keys[r] = round_keys[r-1];
+            add_weyl(round_keys[r]);
+        }
+    }
+
+    key_type get_key() const{
+        return round_keys[0];
+    }
+
+    bool operator==(const ars& rhs) const{
+        return round_keys[0] == rhs.round_keys[0];
+    }
+
+    bool operator!=(const ars& rhs) const{
+        return round_keys[0] != rhs.round_keys[0];
+    }
+
+#if HADOKEN_RANDOM_AESNI
+
+    range_type operator()(const domain_type & counter) const{
+        __m128i v = _mm_xor_si128(load(counter), load(round_keys[0]));
+        for(std::size_t r = 1; r < R; ++r){
+            v = _mm_aesenc_si128(v, load(round_keys[r]));
+        }
+        v = _mm_aesenclast_si128(v, load(round_keys[R]));
+
+        range_type res;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(res.data()), v);
+        return res;
+    }
+
+    ///
+    /// bulk version: encrypt the n consecutive counters counter, counter + 1, ..., counter + n - 1
+    /// into out, with the same result than n calls to operator()
+    ///
+    /// blocks are interleaved by groups of 4 to hide the latency of the AES instructions
+    ///
+    void operator()(const domain_type & counter, range_type* out, std::size_t n) const{
+        static const std::size_t interleave = 4;
+        domain_type c(counter);
+
+        while(n >= interleave){
+            __m128i v[interleave];
+            const __m128i k0 = load(round_keys[0]);
+            for(std::size_t l = 0; l < interleave; ++l){
+                v[l] = _mm_xor_si128(load(c), k0);
+                impl::counter_add(c, uint_type(1));
+            }
+
+            for(std::size_t r = 1; r < R; ++r){
+                const __m128i k = load(round_keys[r]);
+                for(std::size_t l = 0; l < interleave; ++l){
+                    v[l] = _mm_aesenc_si128(v[l], k);
+                }
+            }
+
+            const __m128i k_last = load(round_keys[R]);
+            for(std::size_t l = 0; l < interleave; ++l){
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out[l].data()), _mm_aesenclast_si128(v[l], k_last));
+            }
+
+            out += interleave;
+            n -= interleave;
+        }
+
+        impl::encrypt_counter_blocks(*this, c, out, n);
+    }
+
+#else
+
+    range_type operator()(const domain_type & counter) const{
+        const impl::aes_tables & tables = impl::get_aes_tables();
+
+        range_type v;
+        for(std::size_t i = 0; i < v.size(); ++i){
+            v[i] = counter[i] ^ round_keys[0][i];
+        }
+        for(std::size_t r = 1; r < R; ++r){
+            impl::aes_enc_round(tables, v, round_keys[r]);
+        }
+        impl::aes_enc_last_round(tables, v, round_keys[R]);
+        return v;
+    }
+
+    ///
+    /// bulk version: encrypt the n consecutive counters counter, counter + 1, ..., counter + n - 1
+    /// into out, with the same result than n calls to operator()
+    ///
+    void operator()(const domain_type & counter, range_type* out, std::size_t n) const{
+        impl::encrypt_counter_blocks(*this, counter, out, n);
+    }
+
+#endif
+
+private:
+
+    // the key words are added as two 64 bits integers, like _mm_add_epi64
+    static void add_weyl(key_type & k){
+        const boost::uint64_t low = (boost::uint64_t(k[1]) << 32 | k[0]) + UINT64_C(0x9E3779B97F4A7C15);
+        const boost::uint64_t high = (boost::uint64_t(k[3]) << 32 | k[2]) + UINT64_C(0xBB67AE8584CAA73B);
+        k[0] = static_cast<boost::uint32_t>(low);
+        k[1] = static_cast<boost::uint32_t>(low >> 32);
+        k[2] = static_cast<boost::uint32_t>(high);
+        k[3] = static_cast<boost::uint32_t>(high >> 32);
+    }
+
+#if HADOKEN_RANDOM_AESNI
+    static inline __m128i load(const boost::array<boost::uint32_t, 4> & a){
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data()));
+    }
+#endif
+
+    // round_keys[0] is the user key
+    boost::array<key_type, R+1> round_keys;
+};
+
+
+typedef ars<7> ars4x32;
+
+
+}
+
+#endif // _HADOKEN_RANDOM_ARS_
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdexcept>
 #include <sstream>
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 
@@ -54,7 +55,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///
 ///  counter_engine offers an interface compatible with both C++11 random engine and Boost.Random
 ///
-///  available cbrng backend  are : threefy
+///  available cbrng backend  are : threefry, philox, ars
 ///
 ///
 
@@ -69,23 +70,19 @@ public:
     typedef typename ctr_type::value_type result_type;
     typedef size_t elem_type;
 
-    explicit counter_engine(const key_type &uk) :  b(uk), c(), elem(){}
-    explicit counter_engine(key_type &uk) : b(uk), c(), elem(){}
+    explicit counter_engine(const key_type &uk) :  b(uk), c(), elem(), v(){}
+    explicit counter_engine(key_type &uk) : b(uk), c(), elem(), v(){}
 
-    explicit counter_engine() : b(), c(), elem() {
+    explicit counter_engine() : b(), c(), elem(), v() {
 
     }
-    explicit counter_engine(result_type r) : b(), c(), elem() {
+    explicit counter_engine(result_type r) : b(), c(), elem(), v() {
         key_type key;
         std::fill(key.begin(), key.end(), typename key_type::value_type(r));
         b.set_key(key);
     }
 
 
-    counter_engine(const counter_engine& e) : b(e.b), c(e.c), elem(e.elem){
-    }
-
-
     void seed(result_type r){
         *this = counter_engine(r);
     }
@@ -117,7 +114,7 @@ public:
     }
 
     friend std::ostream& operator<<(std::ostream& os, const counter_engine& be){
-        return os << be.c << " " << be.b.getkey() << " " << be.elem;
+        return os << be.c << " " << be.b.get_key() << " " << be.elem;
     }
 
 
@@ -138,22 +135,98 @@ public:
 
     void discard(boost::uintmax_t skip){
         // any buffered turn need to be dropped
-        while(elem != 0 && skip > 0){
-            skip--;
-            elem--;
-        }
+        const boost::uintmax_t buffered = std::min<boost::uintmax_t>(elem, skip);
+        elem -= buffered;
+        skip -= buffered;
+
         const size_t nelem = c.size();
         boost::uintmax_t counter_increment = skip / nelem;
         boost::uintmax_t counter_rest = skip %  nelem;
         incr_array(c.begin(), c.end(), counter_increment);
 
-        // call generator for remaining turns
-        while(counter_rest--){
+        // remaining turns: start a new block and drop its first values
+        if(counter_rest != 0){
+            incr_array(c.begin(), c.end());
+            v = b(c);
+            elem = nelem - counter_rest;
+        }
+    }
+
+    ///
+    /// return the value at the position stream_index of the stream of the engine key
+    ///
+    /// the stream starts at the initial counter of the engine: value_at(i) is the value returned
+    /// by operator() after discard(i) on a newly seeded engine with the same key.
+    /// It does not depend on the engine state and does not modify it
+    ///
+    result_type value_at(boost::uintmax_t stream_index) const{
+        const size_t nelem = c.size();
+
+        ctr_type ctr;
+        std::fill(ctr.begin(), ctr.end(), typename ctr_type::value_type(0));
+        incr_array(ctr.begin(), ctr.end(), stream_index / nelem);
+        incr_array(ctr.begin(), ctr.end());
+
+        // values of a block are delivered from the last one to the first one by operator()
+        return b(ctr)[nelem - 1 - stream_index % nelem];
+    }
+
+    ///
+    /// return the block of random values for the counter ctr, with the engine key
+    ///
+    ctr_type block_at(const ctr_type & ctr) const{
+        return b(ctr);
+    }
+
+    ///
+    /// fill [first, last) with the next values of the engine
+    ///
+    /// produce exactly the same sequence than a call to operator() for each element
+    /// but the complete blocks are encrypted in batch with the bulk cipher path
+    ///
+    template<typename ForwardIterator>
+    void generate(ForwardIterator first, ForwardIterator last){
+        // any buffered values first
+        while(elem != 0 && first != last){
+            *first = v[--elem];
+            ++first;
+        }
+
+        const std::size_t block_size = c.size();
+        std::size_t n_remain_blocks = static_cast<std::size_t>(std::distance(first, last)) / block_size;
+        ctr_type blocks[generate_batch_blocks];
+
+        while(n_remain_blocks > 0){
+            const std::size_t n_blocks = std::min<std::size_t>(generate_batch_blocks, n_remain_blocks);
+            n_remain_blocks -= n_blocks;
+
+            ctr_type start(c);
+            incr_array(start.begin(), start.end());
+            b(start, blocks, n_blocks);
+            incr_array(c.begin(), c.end(), n_blocks);
 
-            (void) (*this) ();
+            // values of a block are delivered from the last one to the first one by operator()
+            for(std::size_t i = 0; i < n_blocks; ++i){
+                first = std::copy(blocks[i].rbegin(), blocks[i].rend(), first);
+            }
+        }
+
+        // tail: partial block, the remaining values stay buffered
+        while(first != last){
+            *first = (*this)();
+            ++first;
         }
     }
 
+    ///
+    /// fill the n elements of out with the next values of the engine
+    ///
+    /// equivalent to generate(out, out + n)
+    ///
+    void fill(result_type* out, std::size_t n){
+        generate(out, out + n);
+    }
+
     counter_engine<cbrng_type> derivate(const key_type & key) const{
         // for counter engine, derivate need to return a unique counter
         // from a tuple <old_counter_state, old_key, new_key>
@@ -161,35 +234,28 @@ public:
         // to achive this we rely on the block cipher properties
         // of the counter based random generators
         // new_key = cipher_block(key, cipher_block(old_key, old_counter_state))
-
-        counter_engine<cbrng_type> derivate_counter(*this);
-        // call the new counter with the old key and old counter value
-        // to get a value function of the counter state and the counter key
-        (void) derivate_counter();
-
-        // now we setup the new key
-        derivate_counter.b.set_key(key);
-
-        // do a simple rotation based on the elem value
-        // to take into consideration "elem" without
-        std::rotate(derivate_counter.v.begin(), derivate_counter.v.begin()+elem, derivate_counter.v.end());
-
-        // and using previous rotate generated block as element
-        key_type new_key= derivate_counter.b(derivate_counter.v);
-        // use the new key as counter
-        derivate_counter.seed(new_key);
-
-        return derivate_counter;
+        return derivate_from_block(derivation_block(), key);
     }
 
     counter_engine<cbrng_type> derivate(result_type r) const{
-            key_type key;
-            std::fill(key.begin(), key.end(), typename key_type::value_type(r));
-            return derivate(key);
-        }
-
-         
+        return derivate(make_key(r));
+    }
 
+    ///
+    /// derivate n engines at once: out[i] = derivate(keys[i]) for i in [0, n)
+    ///
+    /// keys can be keys ( key_type ) or integers ( result_type ).
+    /// The block function of the engine state is computed once, then each
+    /// derivated engine costs a single keyed block encryption
+    ///
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator derivate_n(InputIterator keys, std::size_t n, OutputIterator out) const{
+        const ctr_type block = derivation_block();
+        for(std::size_t i = 0; i < n; ++i, ++keys, ++out){
+            *out = derivate_from_block(block, make_key(*keys));
+        }
+        return out;
+    }
 
     ctr_type operator()(const ctr_type& c) const{
         return b(c);
@@ -197,7 +263,7 @@ public:
 
 
     key_type getseed() const{
-        return c.get_key();
+        return b.get_key();
     }
 
 
@@ -209,9 +275,55 @@ public:
 
 private:
 
+    static key_type make_key(const key_type & key){
+        return key;
+    }
+
+    static key_type make_key(result_type r){
+        key_type key;
+        std::fill(key.begin(), key.end(), typename key_type::value_type(r));
+        return key;
+    }
+
+    // value function of the counter state and of the counter key used by the derivation:
+    // the block of the next counter, or the current block if values are still buffered,
+    // rotated by the number of buffered values
+    ctr_type derivation_block() const{
+        ctr_type block;
+        if(elem == 0){
+            ctr_type next(c);
+            incr_array(next.begin(), next.end());
+            block = b(next);
+        }else{
+            block = v;
+        }
+        std::rotate(block.begin(), block.begin() + elem, block.end());
+        return block;
+    }
+
+    // new engine keyed by the encryption of the derivation block with the derivation key
+    static counter_engine<cbrng_type> derivate_from_block(const ctr_type & block, const key_type & key){
+        const cbrng_type keyed_cbrng(key);
+        const key_type new_key = block_to_key(keyed_cbrng(block));
+        return counter_engine<cbrng_type>(new_key);
+    }
+
+    // fold a block into a key, identity when key and block have the same size
+    // ( e.g philox keys are half the size of a block )
+    static key_type block_to_key(const ctr_type & block){
+        key_type key;
+        std::fill(key.begin(), key.end(), typename key_type::value_type(0));
+        for(std::size_t i = 0; i < block.size(); ++i){
+            key[i % key.size()] ^= block[i];
+        }
+        return key;
+    }
+
+    // number of blocks encrypted per batch by generate(), small enough to stay in L1
+    static const std::size_t generate_batch_blocks = 64;
 
     template<typename Iterator>
-    inline void incr_array(Iterator start, Iterator finish){
+    static inline void incr_array(Iterator start, Iterator finish){
         static const typename cbrng_type::uint_type max_elem = std::numeric_limits<typename cbrng_type::uint_type>::max();
 
         while( start != finish){
@@ -226,7 +338,7 @@ private:
     }
 
     template<typename Iterator>
-    void incr_array(Iterator start, Iterator finish, boost::uintmax_t inc_val){
+    static void incr_array(Iterator start, Iterator finish, boost::uintmax_t inc_val){
         static const typename cbrng_type::uint_type max_elem = std::numeric_limits<typename cbrng_type::uint_type>::max();
 
         if(inc_val ==0 || start == finish){
@@ -253,6 +365,9 @@ private:
 
 };
 
+template<typename CBRNG>
+const std::size_t counter_engine<CBRNG>::generate_batch_blocks;
+
 
 // specialize random_engine_derivate
 // for counter base random generator
@@ -261,6 +376,11 @@ inline counter_engine<CBRNG> random_engine_derivate(const counter_engine<CBRNG>
     return engine.derivate(key);
 }
 
+template<typename CBRNG, typename InputIterator, typename OutputIterator>
+inline OutputIterator random_engine_derivate_n(const counter_engine<CBRNG> & engine, InputIterator keys, std::size_t n, OutputIterator out){
+    return engine.derivate_n(keys, n, out);
+}
+
 
 } //_HADOKEN_COUNTER_ENGINE_HPP_
 
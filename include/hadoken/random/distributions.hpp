@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+#ifndef _HADOKEN_RANDOM_DISTRIBUTIONS_HPP_
+#define _HADOKEN_RANDOM_DISTRIBUTIONS_HPP_
+
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include <hadoken/random/counter_engine.hpp>
+#include <hadoken/random/random_engine_mapper.hpp>
+
+#include "impl/distributions_impl.hpp"
+
+
+///
+/// real distributions for engines producing full range unsigned integers
+/// ( counter engines, random_engine_mapper, mt19937, ... )
+///
+/// Each distribution can be used value by value with operator(), like the C++11 / boost.Random
+/// distributions, or in bulk with generate(engine, first, last): the random words are then
+/// produced by block with the bulk path of the engine ( counter_engine::fill, random_engine_mapper::fill )
+/// and converted by chunk in loops without branches that the compiler can vectorize.
+///
+/// generate() produces the same sequence than the same number of calls to operator()
+///
+
+namespace hadoken{
+
+
+namespace impl{
+
+template<typename Engine>
+inline void check_full_range_engine(const Engine &){
+    assert((Engine::min)() == 0 && (Engine::max)() == std::numeric_limits<typename Engine::result_type>::max()
+           && "the distribution requires an engine producing full range unsigned integers");
+}
+
+} // impl
+
+
+///
+/// uniform distribution in [0, 1)
+///
+/// the random bits are put in the mantissa of a floating point number in [1, 2)
+///
+template<typename Real = double>
+class uniform01{
+public:
+    typedef Real result_type;
+    typedef typename impl::uniform01_bits<Real>::uint_type uint_type;
+
+    uniform01(){}
+
+    void reset(){}
+
+    result_type min() const{
+        return result_type(0);
+    }
+
+    result_type max() const{
+        return result_type(1);
+    }
+
+    template<typename Engine>
+    result_type operator()(Engine & engine){
+        impl::check_full_range_engine(engine);
+        return impl::uniform01_from_bits<Real>(impl::draw_word<uint_type>(engine));
+    }
+
+    template<typename Engine, typename OutputIterator>
+    void generate(Engine & engine, OutputIterator first, OutputIterator last){
+        impl::check_full_range_engine(engine);
+        impl::generate_uniform_transform<Real>(engine, first, last, identity());
+    }
+
+    friend bool operator==(const uniform01 &, const uniform01 &){
+        return true;
+    }
+
+    friend bool operator!=(const uniform01 &, const uniform01 &){
+        return false;
+    }
+
+private:
+    struct identity{
+        inline Real operator()(Real u) const{
+            return u;
+        }
+    };
+};
+
+
+///
+/// normal distribution of mean and standard deviation sigma,
+/// generated by pairs with the Box-Muller transform
+///
+/// the logarithm, sine and cosine are evaluated by polynomials without branch
+/// ( impl::fast_log, impl::sincos_from_bits ) for the conversion loop of generate()
+///
+template<typename Real = double>
+class normal_distribution{
+public:
+    typedef Real result_type;
+    typedef typename impl::uniform01_bits<Real>::uint_type uint_type;
+
+    explicit normal_distribution(Real mean = Real(0), Real sigma = Real(1)) :
+        _mean(mean), _sigma(sigma), _cached(), _has_cached(false){
+        assert(sigma >= Real(0));
+    }
+
+    /// drop the second value of the last generated pair
+    void reset(){
+        _has_cached = false;
+    }
+
+    Real mean() const{
+        return _mean;
+    }
+
+    Real sigma() const{
+        return _sigma;
+    }
+
+    result_type min() const{
+        return -std::numeric_limits<Real>::infinity();
+    }
+
+    result_type max() const{
+        return std::numeric_limits<Real>::infinity();
+    }
+
+    template<typename Engine>
+    result_type operator()(Engine & engine){
+        impl::check_full_range_engine(engine);
+        if(_has_cached){
+            _has_cached = false;
+            return _mean + _sigma * _cached;
+        }
+
+        const uint_type w1 = impl::draw_word<uint_type>(engine);
+        const uint_type w2 = impl::draw_word<uint_type>(engine);
+
+        Real z0;
+        impl::box_muller<Real>(w1, w2, z0, _cached);
+        _has_cached = true;
+        return _mean + _sigma * z0;
+    }
+
+    template<typename Engine, typename OutputIterator>
+    void generate(Engine & engine, OutputIterator first, OutputIterator last){
+        typedef typename Engine::result_type engine_uint;
+        const std::size_t draws = impl::draws_per_word<engine_uint, uint_type>::value;
+        const std::size_t chunk_pairs = impl::distribution_chunk_size / 2;
+
+        impl::check_full_range_engine(engine);
+
+        std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        if(n > 0 && _has_cached){
+            *first = (*this)(engine);
+            ++first;
+            --n;
+        }
+
+        engine_uint raw[chunk_pairs * 2 * draws];
+        Real values[chunk_pairs * 2];
+
+        while(n >= 2){
+            const std::size_t n_pairs = std::min<std::size_t>(chunk_pairs, n / 2);
+
+            impl::engine_generate_n(engine, raw, n_pairs * 2 * draws);
+            for(std::size_t i = 0; i < n_pairs; ++i){
+                Real z0, z1;
+                impl::box_muller<Real>(impl::word_from_draws<uint_type>(raw + (2 * i) * draws),
+                                       impl::word_from_draws<uint_type>(raw + (2 * i + 1) * draws), z0, z1);
+                values[2 * i] = _mean + _sigma * z0;
+                values[2 * i + 1] = _mean + _sigma * z1;
+            }
+
+            first = std::copy(values, values + 2 * n_pairs, first);
+            n -= 2 * n_pairs;
+        }
+
+        // odd size: the second value of the last pair stays cached
+        if(n > 0){
+            *first = (*this)(engine);
+        }
+    }
+
+    friend bool operator==(const normal_distribution & lhs, const normal_distribution & rhs){
+        return lhs._mean == rhs._mean && lhs._sigma == rhs._sigma;
+    }
+
+    friend bool operator!=(const normal_distribution & lhs, const normal_distribution & rhs){
+        return !(lhs == rhs);
+    }
+
+private:
+    Real _mean, _sigma;
+    Real _cached;
+    bool _has_cached;
+};
+
+
+///
+/// exponential distribution of rate lambda, by inversion
+///
+template<typename Real = double>
+class exponential_distribution{
+public:
+    typedef Real result_type;
+    typedef typename impl::uniform01_bits<Real>::uint_type uint_type;
+
+    explicit exponential_distribution(Real lambda = Real(1)) : _lambda(lambda){
+        assert(lambda > Real(0));
+    }
+
+    void reset(){}
+
+    Real lambda() const{
+        return _lambda;
+    }
+
+    result_type min() const{
+        return Real(0);
+    }
+
+    result_type max() const{
+        return std::numeric_limits<Real>::infinity();
+    }
+
+    template<typename Engine>
+    result_type operator()(Engine & engine){
+        impl::check_full_range_engine(engine);
+        return transform(_lambda)(impl::uniform01_from_bits<Real>(impl::draw_word<uint_type>(engine)));
+    }
+
+    template<typename Engine, typename OutputIterator>
+    void generate(Engine & engine, OutputIterator first, OutputIterator last){
+        impl::check_full_range_engine(engine);
+        impl::generate_uniform_transform<Real>(engine, first, last, transform(_lambda));
+    }
+
+    friend bool operator==(const exponential_distribution & lhs, const exponential_distribution & rhs){
+        return lhs._lambda == rhs._lambda;
+    }
+
+    friend bool operator!=(const exponential_distribution & lhs, const exponential_distribution & rhs){
+        return !(lhs == rhs);
+    }
+
+private:
+    struct transform{
+        explicit transform(Real lambda) : inv_lambda(Real(1) / lambda){}
+
+        // 1 - u in (0, 1] for the logarithm
+        inline Real operator()(Real u) const{
+            return -impl::fast_log(Real(1) - u) * inv_lambda;
+        }
+
+        Real inv_lambda;
+    };
+
+    Real _lambda;
+};
+
+
+}
+
+#endif // _HADOKEN_RANDOM_DISTRIBUTIONS_HPP_
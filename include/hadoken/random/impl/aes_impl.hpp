@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+#ifndef _HADOKEN_RANDOM_AES_IMPL_HPP_
+#define _HADOKEN_RANDOM_AES_IMPL_HPP_
+
+#include <cstddef>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+
+///
+/// HADOKEN_RANDOM_AESNI is 1 when the AES round instructions
+/// are enabled at compile time ( e.g -maes, -march=native )
+///
+/// the portable implementation of the AES round is used otherwise,
+/// or when HADOKEN_RANDOM_AESNI=0
+///
+#ifndef HADOKEN_RANDOM_AESNI
+#if defined(__AES__) && defined(__SSE2__)
+#define HADOKEN_RANDOM_AESNI 1
+#else
+#define HADOKEN_RANDOM_AESNI 0
+#endif
+#endif
+
+#if HADOKEN_RANDOM_AESNI
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+
+namespace hadoken {
+
+namespace impl {
+
+
+/// AES state of 16 bytes as 4 little endian columns,
+/// the same memory layout than the 128 bits registers used by AES-NI
+typedef boost::array<boost::uint32_t, 4> aes_block;
+
+
+/// S-box and encryption table of the AES round
+struct aes_tables{
+
+    aes_tables(){
+        // S-box from the multiplicative inverse in GF(2^8) and the affine transform,
+        // p walks the field by powers of 3 and q by powers of its inverse
+        boost::uint8_t p = 1, q = 1;
+        do{
+            p = static_cast<boost::uint8_t>(p ^ (p << 1) ^ ((p & 0x80) ? 0x1B : 0));
+
+            q = static_cast<boost::uint8_t>(q ^ (q << 1));
+            q = static_cast<boost::uint8_t>(q ^ (q << 2));
+            q = static_cast<boost::uint8_t>(q ^ (q << 4));
+            if(q & 0x80){
+                q ^= 0x09;
+            }
+
+            const boost::uint8_t affine = static_cast<boost::uint8_t>(q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4));
+            sbox[p] = static_cast<boost::uint8_t>(affine ^ 0x63);
+        } while(p != 1);
+        sbox[0] = 0x63;
+
+        // te0 column contribution of a row 0 byte after SubBytes and MixColumns: { 2.s, s, s, 3.s }
+        for(std::size_t i = 0; i < 256; ++i){
+            const boost::uint32_t s = sbox[i];
+            const boost::uint32_t s2 = xtime(sbox[i]);
+            te0[i] = s2 | (s << 8) | (s << 16) | ((s2 ^ s) << 24);
+        }
+    }
+
+    static inline boost::uint8_t rotl8(boost::uint8_t x, unsigned s){
+        return static_cast<boost::uint8_t>((x << s) | (x >> (8 - s)));
+    }
+
+    static inline boost::uint32_t xtime(boost::uint8_t x){
+        return static_cast<boost::uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+    }
+
+    boost::uint8_t sbox[256];
+    boost::uint32_t te0[256];
+};
+
+
+inline const aes_tables & get_aes_tables(){
+    static const aes_tables tables;
+    return tables;
+}
+
+
+inline boost::uint32_t aes_rotl32(boost::uint32_t x, unsigned s){
+    return (x << s) | (x >> (32 - s));
+}
+
+
+/// portable equivalent of AESENC: ShiftRows, SubBytes, MixColumns and AddRoundKey
+inline void aes_enc_round(const aes_tables & t, aes_block & state, const aes_block & round_key){
+    aes_block res;
+    for(std::size_t c = 0; c < 4; ++c){
+        // ShiftRows: row r of the column c comes from the column c + r
+        res[c] = t.te0[state[c] & 0xFF]
+                ^ aes_rotl32(t.te0[(state[(c + 1) % 4] >> 8) & 0xFF], 8)
+                ^ aes_rotl32(t.te0[(state[(c + 2) % 4] >> 16) & 0xFF], 16)
+                ^ aes_rotl32(t.te0[state[(c + 3) % 4] >> 24], 24)
+                ^ round_key[c];
+    }
+    state = res;
+}
+
+
+/// portable equivalent of AESENCLAST: ShiftRows, SubBytes and AddRoundKey
+inline void aes_enc_last_round(const aes_tables & t, aes_block & state, const aes_block & round_key){
+    aes_block res;
+    for(std::size_t c = 0; c < 4; ++c){
+        res[c] = (boost::uint32_t(t.sbox[state[c] & 0xFF]))
+                ^ (boost::uint32_t(t.sbox[(state[(c + 1) % 4] >> 8) & 0xFF]) << 8)
+                ^ (boost::uint32_t(t.sbox[(state[(c + 2) % 4] >> 16) & 0xFF]) << 16)
+                ^ (boost::uint32_t(t.sbox[state[(c + 3) % 4] >> 24]) << 24)
+                ^ round_key[c];
+    }
+    state = res;
+}
+
+
+inline void aes_enc_round(aes_block & state, const aes_block & round_key){
+    aes_enc_round(get_aes_tables(), state, round_key);
+}
+
+inline void aes_enc_last_round(aes_block & state, const aes_block & round_key){
+    aes_enc_last_round(get_aes_tables(), state, round_key);
+}
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_RANDOM_AES_IMPL_HPP_
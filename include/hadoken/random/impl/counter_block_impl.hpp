@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+#ifndef _HADOKEN_RANDOM_COUNTER_BLOCK_IMPL_HPP_
+#define _HADOKEN_RANDOM_COUNTER_BLOCK_IMPL_HPP_
+
+#include <cstddef>
+
+#include <boost/array.hpp>
+
+
+namespace hadoken {
+
+namespace impl {
+
+
+/// add inc to a counter stored as a little endian multi word integer
+template<typename Uint, std::size_t N>
+inline void counter_add(boost::array<Uint, N> & c, Uint inc){
+    for(std::size_t i = 0; i < N && inc != 0; ++i){
+        const Uint prev = c[i];
+        c[i] += inc;
+        inc = (c[i] < prev) ? 1 : 0;
+    }
+}
+
+
+///
+/// generic bulk encryption: out[i] = cipher(counter + i) for i in [0, n)
+///
+/// used by the counter based generators without dedicated multi block kernel
+///
+template<typename Cipher, typename Uint, std::size_t N>
+inline void encrypt_counter_blocks(const Cipher & cipher, const boost::array<Uint, N> & counter,
+                                   boost::array<Uint, N>* out, std::size_t n){
+    boost::array<Uint, N> c(counter);
+    for(std::size_t i = 0; i < n; ++i){
+        out[i] = cipher(c);
+        counter_add(c, Uint(1));
+    }
+}
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_RANDOM_COUNTER_BLOCK_IMPL_HPP_
@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+#ifndef _HADOKEN_RANDOM_DISTRIBUTIONS_IMPL_HPP_
+#define _HADOKEN_RANDOM_DISTRIBUTIONS_IMPL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <hadoken/random/random_engine_mapper.hpp>
+
+
+namespace hadoken {
+
+namespace impl {
+
+
+/// bit layout of the floating point types used by the uniform01 conversion
+template<typename Real>
+struct uniform01_bits{
+    BOOST_STATIC_ASSERT(sizeof(Real) == 0 && "only float and double are supported");
+};
+
+template<>
+struct uniform01_bits<double>{
+    typedef boost::uint64_t uint_type;
+    static const unsigned mantissa_digits = 52;
+    static const boost::uint64_t one = UINT64_C(0x3FF0000000000000);
+};
+
+template<>
+struct uniform01_bits<float>{
+    typedef boost::uint32_t uint_type;
+    static const unsigned mantissa_digits = 23;
+    static const boost::uint32_t one = UINT32_C(0x3F800000);
+};
+
+
+///
+/// uniform value in [0, 1) from random bits, without division nor conversion:
+/// the high bits of u become the mantissa of a number in [1, 2) minus 1
+///
+template<typename Real>
+inline Real uniform01_from_bits(typename uniform01_bits<Real>::uint_type u){
+    typedef uniform01_bits<Real> bits_traits;
+    typedef typename bits_traits::uint_type uint_type;
+
+    const uint_type bits = (u >> (std::numeric_limits<uint_type>::digits - bits_traits::mantissa_digits)) | bits_traits::one;
+    Real res;
+    std::memcpy(&res, &bits, sizeof(Real));
+    return res - Real(1);
+}
+
+
+///
+/// number of engine values consumed by random word of type Uint:
+/// two 32 bits values for a 64 bits word, one otherwise
+///
+template<typename EngineUint, typename Uint>
+struct draws_per_word{
+    static const std::size_t value = (sizeof(Uint) > sizeof(EngineUint)) ? (sizeof(Uint) / sizeof(EngineUint)) : 1;
+};
+
+
+template<typename Uint, typename EngineUint>
+inline Uint word_from_draws(const EngineUint* draws, boost::true_type){
+    Uint res = 0;
+    for(std::size_t i = 0; i < draws_per_word<EngineUint, Uint>::value; ++i){
+        res = static_cast<Uint>((res << std::numeric_limits<EngineUint>::digits) | draws[i]);
+    }
+    return res;
+}
+
+template<typename Uint, typename EngineUint>
+inline Uint word_from_draws(const EngineUint* draws, boost::false_type){
+    // keep the high bits of bigger values
+    return static_cast<Uint>(draws[0] >> (std::numeric_limits<EngineUint>::digits - std::numeric_limits<Uint>::digits));
+}
+
+/// assemble a random word of type Uint from draws_per_word engine values,
+/// the first value gives the high bits
+template<typename Uint, typename EngineUint>
+inline Uint word_from_draws(const EngineUint* draws){
+    return word_from_draws<Uint>(draws, boost::integral_constant<bool, (sizeof(Uint) > sizeof(EngineUint))>());
+}
+
+
+/// draw a random word of type Uint from the engine, one value at a time
+template<typename Uint, typename Engine>
+inline Uint draw_word(Engine & engine){
+    typedef typename Engine::result_type engine_uint;
+    engine_uint draws[draws_per_word<engine_uint, Uint>::value];
+    for(std::size_t i = 0; i < draws_per_word<engine_uint, Uint>::value; ++i){
+        draws[i] = engine();
+    }
+    return word_from_draws<Uint>(draws);
+}
+
+
+///
+/// natural logarithm of a positive normal number, without branch nor call to the libm,
+/// to keep the conversion loops of the bulk distributions vectorizable
+///
+/// x = m * 2^e with m in [sqrt(2)/2, sqrt(2)), and log(m) = 2 atanh((m - 1) / (m + 1))
+/// from its series, accurate to a few ulps
+///
+template<typename Real>
+inline Real fast_log(Real x){
+    typedef uniform01_bits<Real> bits_traits;
+    typedef typename bits_traits::uint_type uint_type;
+    const unsigned mantissa_digits = bits_traits::mantissa_digits;
+    const uint_type mantissa_mask = (uint_type(1) << mantissa_digits) - 1;
+    // 2^mantissa_digits, used to convert the biased exponent without integer to float conversion
+    const uint_type magic = bits_traits::one + (uint_type(mantissa_digits) << mantissa_digits);
+    const Real exponent_bias = Real(std::numeric_limits<Real>::max_exponent - 1);
+
+    uint_type bits;
+    std::memcpy(&bits, &x, sizeof(Real));
+
+    const uint_type exponent_bits = (bits >> mantissa_digits) | magic;
+    const uint_type mantissa_bits = (bits & mantissa_mask) | bits_traits::one;
+    Real e, m;
+    std::memcpy(&e, &exponent_bits, sizeof(Real));
+    std::memcpy(&m, &mantissa_bits, sizeof(Real));
+    e -= Real(uint_type(1) << mantissa_digits) + exponent_bias;
+
+    const bool high = (m > Real(1.4142135623730950488016887242097));
+    m = high ? (m * Real(0.5)) : m;
+    e = high ? (e + Real(1)) : e;
+
+    const Real t = (m - Real(1)) / (m + Real(1));
+    const Real t2 = t * t;
+    const Real p = Real(1) + t2 * (Real(1.0 / 3) + t2 * (Real(1.0 / 5) + t2 * (Real(1.0 / 7) + t2 * (Real(1.0 / 9)
+                   + t2 * (Real(1.0 / 11) + t2 * (Real(1.0 / 13) + t2 * (Real(1.0 / 15) + t2 * (Real(1.0 / 17)
+                   + t2 * (Real(1.0 / 19) + t2 * Real(1.0 / 21))))))))));
+
+    // log(2) split in a part exact in multiplication by e and a correction
+    const Real ln2_hi = Real(6.93147180369123816490e-01), ln2_lo = Real(1.90821492927058770002e-10);
+    return e * ln2_hi + (e * ln2_lo + Real(2) * t * p);
+}
+
+
+///
+/// sine and cosine of theta in [0, pi / 2] from their Taylor series
+///
+template<typename Real>
+inline void sincos_quarter(Real theta, Real & s, Real & c){
+    const Real t2 = theta * theta;
+    s = theta * (Real(1) + t2 * (Real(-1.6666666666666666e-01) + t2 * (Real(8.333333333333333e-03)
+        + t2 * (Real(-1.984126984126984e-04) + t2 * (Real(2.7557319223985893e-06) + t2 * (Real(-2.505210838544172e-08)
+        + t2 * (Real(1.6059043836821613e-10) + t2 * (Real(-7.647163731819816e-13) + t2 * (Real(2.8114572543455206e-15)
+        + t2 * (Real(-8.22063524662433e-18) + t2 * (Real(1.9572941063391263e-20) + t2 * Real(-3.868170170630684e-23))))))))))));
+    c = Real(1) + t2 * (Real(-0.5) + t2 * (Real(4.1666666666666664e-02) + t2 * (Real(-1.388888888888889e-03)
+        + t2 * (Real(2.48015873015873e-05) + t2 * (Real(-2.755731922398589e-07) + t2 * (Real(2.08767569878681e-09)
+        + t2 * (Real(-1.1470745597729725e-11) + t2 * (Real(4.779477332387385e-14) + t2 * (Real(-1.5619206968586225e-16)
+        + t2 * (Real(4.110317623312165e-19) + t2 * Real(-8.896791392450574e-22)))))))))));
+}
+
+
+///
+/// sine and cosine of the angle 2 pi w / 2^digits for a random word w:
+/// the two high bits select the quadrant and the others the angle inside it
+///
+template<typename Real>
+inline void sincos_from_bits(typename uniform01_bits<Real>::uint_type w, Real & s, Real & c){
+    typedef typename uniform01_bits<Real>::uint_type uint_type;
+    const Real half_pi = Real(1.5707963267948966192313216916398);
+    const uint_type quadrant = w >> (std::numeric_limits<uint_type>::digits - 2);
+
+    Real qs, qc;
+    sincos_quarter(half_pi * uniform01_from_bits<Real>(static_cast<uint_type>(w << 2)), qs, qc);
+
+    // rotation of quadrant * pi / 2
+    const bool swap = (quadrant & 1) != 0;
+    const bool neg_sin = (quadrant & 2) != 0;
+    const bool neg_cos = ((quadrant ^ (quadrant >> 1)) & 1) != 0;
+    const Real rs = swap ? qc : qs;
+    const Real rc = swap ? qs : qc;
+    s = neg_sin ? -rs : rs;
+    c = neg_cos ? -rc : rc;
+}
+
+
+/// Box-Muller transform of two random words into two independent normal values
+template<typename Real>
+inline void box_muller(typename uniform01_bits<Real>::uint_type w1, typename uniform01_bits<Real>::uint_type w2,
+                       Real & z0, Real & z1){
+    // u1 in (0, 1] for the logarithm
+    const Real u1 = Real(1) - uniform01_from_bits<Real>(w1);
+    const Real radius = std::sqrt(Real(-2) * fast_log(u1));
+    Real s, c;
+    sincos_from_bits<Real>(w2, s, c);
+    z0 = radius * c;
+    z1 = radius * s;
+}
+
+
+/// number of values converted by chunk by the bulk distributions
+const std::size_t distribution_chunk_size = 256;
+
+
+///
+/// fill [first, last) with the transform of uniform values in [0, 1),
+/// random words are generated by chunk with the bulk path of the engine
+///
+template<typename Real, typename Engine, typename OutputIterator, typename Transform>
+inline void generate_uniform_transform(Engine & engine, OutputIterator first, OutputIterator last, Transform transform){
+    typedef typename Engine::result_type engine_uint;
+    typedef typename uniform01_bits<Real>::uint_type uint_type;
+    const std::size_t draws = draws_per_word<engine_uint, uint_type>::value;
+
+    engine_uint raw[distribution_chunk_size * draws];
+    Real values[distribution_chunk_size];
+
+    while(first != last){
+        std::size_t n = 0;
+        OutputIterator chunk_last = first;
+        while(n < distribution_chunk_size && chunk_last != last){
+            ++n;
+            ++chunk_last;
+        }
+
+        engine_generate_n(engine, raw, n * draws);
+        for(std::size_t i = 0; i < n; ++i){
+            values[i] = transform(uniform01_from_bits<Real>(word_from_draws<uint_type>(raw + i * draws)));
+        }
+        first = std::copy(values, values + n, first);
+    }
+}
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_RANDOM_DISTRIBUTIONS_IMPL_HPP_
@@ -99,6 +99,15 @@ inline Engine random_engine_derivate(const Engine & engine, const typename Engin
 }
 
 
+template<typename Engine, typename InputIterator, typename OutputIterator>
+inline OutputIterator random_engine_derivate_n(const Engine & engine, InputIterator keys, std::size_t n, OutputIterator out){
+    for(std::size_t i = 0; i < n; ++i, ++keys, ++out){
+        *out = random_engine_derivate(engine, static_cast<typename Engine::result_type>(*keys));
+    }
+    return out;
+}
+
+
 
 } // end hadoken
 
@@ -5,6 +5,11 @@
 
 
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include <boost/type_traits/is_same.hpp>
 
 #include <hadoken/random/random_engine_mapper.hpp>
 #include <hadoken/random/random_derivate.hpp>
@@ -14,6 +19,34 @@ namespace hadoken {
 namespace impl{
 
 
+/// fill out with n values of the engine, one call to the engine by value
+template<typename Engine, typename Uint>
+inline void engine_generate_n(Engine & e, Uint* out, std::size_t n){
+    for(std::size_t i = 0; i < n; ++i){
+        out[i] = e();
+    }
+}
+
+template<typename CBRNG, typename Uint>
+inline void engine_generate_n_counter(counter_engine<CBRNG> & e, Uint* out, std::size_t n, boost::true_type){
+    e.fill(out, n);
+}
+
+template<typename CBRNG, typename Uint>
+inline void engine_generate_n_counter(counter_engine<CBRNG> & e, Uint* out, std::size_t n, boost::false_type){
+    for(std::size_t i = 0; i < n; ++i){
+        out[i] = e();
+    }
+}
+
+/// counter engines of the same value type are filled with their bulk path
+template<typename CBRNG, typename Uint>
+inline void engine_generate_n(counter_engine<CBRNG> & e, Uint* out, std::size_t n){
+    engine_generate_n_counter(e, out, n,
+                              typename boost::is_same<Uint, typename counter_engine<CBRNG>::result_type>::type());
+}
+
+
 
 template< typename Uint >
 class abstract_engine {
@@ -29,9 +62,20 @@ public:
 
     virtual result_type generate() =0;
 
-    virtual abstract_engine* clone() =0;
+    /// fill out with the n next values of the engine
+    virtual void generate(result_type* out, std::size_t n) =0;
+
+    ///
+    /// copy the engine in storage if it fits in storage_size bytes,
+    /// or on the heap otherwise ( storage can be NULL )
+    ///
+    virtual abstract_engine* clone(void* storage, std::size_t storage_size) const =0;
+
+    /// same than clone() but move the engine
+    virtual abstract_engine* move(void* storage, std::size_t storage_size) =0;
 
-    virtual abstract_engine* derivate(result_type key) const =0;
+    /// derivate the engine in storage or on the heap, same rules than clone()
+    virtual abstract_engine* derivate(result_type key, void* storage, std::size_t storage_size) const =0;
 
 private:
 };
@@ -45,6 +89,9 @@ public:
     map_engine_intern(const Engine & e) : _e(e){
     }
 
+    map_engine_intern(Engine && e) : _e(std::move(e)){
+    }
+
     virtual void map_seed(){
         _e.seed();
     }
@@ -57,14 +104,32 @@ public:
         return _e();
     }
 
-    virtual abstract_engine<result_type>* clone(){
-           return new map_engine_intern(_e);
+    virtual void generate(result_type* out, std::size_t n){
+        engine_generate_n(_e, out, n);
+    }
+
+    virtual abstract_engine<result_type>* clone(void* storage, std::size_t storage_size) const{
+        if(fits(storage, storage_size)){
+            return new (storage) map_engine_intern(_e);
+        }
+        return new map_engine_intern(_e);
     }
 
-    virtual abstract_engine<result_type>* derivate(result_type key) const{
-        Engine derivated_engine = random_engine_derivate(_e, key);
-        map_engine_intern<result_type, Engine>* ret = new map_engine_intern<result_type, Engine>(derivated_engine);
-        return ret;
+    virtual abstract_engine<result_type>* move(void* storage, std::size_t storage_size){
+        if(fits(storage, storage_size)){
+            return new (storage) map_engine_intern(std::move(_e));
+        }
+        return new map_engine_intern(std::move(_e));
+    }
+
+    virtual abstract_engine<result_type>* derivate(result_type key, void* storage, std::size_t storage_size) const{
+        map_engine_intern derivated_engine(random_engine_derivate(_e, key));
+        return derivated_engine.move(storage, storage_size);
+    }
+
+    static bool fits(void* storage, std::size_t storage_size){
+        return storage != NULL && sizeof(map_engine_intern) <= storage_size
+                && alignof(map_engine_intern) <= alignof(std::max_align_t);
     }
 
 private:
@@ -74,56 +139,150 @@ private:
 
 }
 
-template< typename Uint >
+template< typename Uint, std::size_t InlineSize >
 template< typename Engine >
-random_engine_mapper<Uint>::random_engine_mapper(const Engine & e) : _engine(new impl::map_engine_intern<Uint, Engine>(e)){
+random_engine_mapper<Uint, InlineSize>::random_engine_mapper(const Engine & e) : _storage(), _engine(NULL),
+    _buffer(), _buffer_pos(buffer_size){
+    const impl::map_engine_intern<Uint, Engine> mapped(e);
+    _engine = mapped.clone(storage(), InlineSize);
+}
+
+
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize>::random_engine_mapper() : _storage(), _engine(NULL), _buffer(), _buffer_pos(buffer_size) {
+
+}
 
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize>::random_engine_mapper(const random_engine_mapper & other) : _storage(), _engine(NULL),
+    _buffer(other._buffer), _buffer_pos(other._buffer_pos){
+    if(other._engine != NULL){
+        _engine = other._engine->clone(storage(), InlineSize);
+    }
 }
 
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize>::random_engine_mapper(random_engine_mapper && other) : _storage(), _engine(NULL),
+    _buffer(other._buffer), _buffer_pos(other._buffer_pos){
+    move_from(other);
+}
 
-template< typename Uint >
-random_engine_mapper<Uint>::random_engine_mapper() : _engine() {
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize>::~random_engine_mapper(){
+    reset();
+}
 
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize> & random_engine_mapper<Uint, InlineSize>::operator=(const random_engine_mapper & other){
+    if(this != &other){
+        reset();
+        if(other._engine != NULL){
+            _engine = other._engine->clone(storage(), InlineSize);
+        }
+        _buffer = other._buffer;
+        _buffer_pos = other._buffer_pos;
+    }
+    return *this;
 }
 
-template< typename Uint >
-random_engine_mapper<Uint>::random_engine_mapper(const random_engine_mapper<Uint> & other) : _engine(NULL){
-    if(other._engine.get() != NULL){
-        _engine.reset(other._engine->clone());
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize> & random_engine_mapper<Uint, InlineSize>::operator=(random_engine_mapper && other){
+    if(this != &other){
+        reset();
+        _buffer = other._buffer;
+        _buffer_pos = other._buffer_pos;
+        move_from(other);
     }
+    return *this;
 }
 
-template< typename Uint >
-void random_engine_mapper<Uint>::seed(){
-    assert(_engine.get());
+template< typename Uint, std::size_t InlineSize >
+void random_engine_mapper<Uint, InlineSize>::reset(){
+    if(inline_storage()){
+        _engine->~abstract_engine();
+    }else{
+        delete _engine;
+    }
+    _engine = NULL;
+}
+
+template< typename Uint, std::size_t InlineSize >
+void random_engine_mapper<Uint, InlineSize>::move_from(random_engine_mapper & other){
+    if(other.inline_storage()){
+        _engine = other._engine->move(storage(), InlineSize);
+        other.reset();
+    }else{
+        // heap allocated engine: take the ownership
+        _engine = other._engine;
+        other._engine = NULL;
+    }
+    other._buffer_pos = buffer_size;
+}
+
+template< typename Uint, std::size_t InlineSize >
+bool random_engine_mapper<Uint, InlineSize>::inline_storage() const{
+    const char* engine_ptr = reinterpret_cast<const char*>(_engine);
+    const char* storage_ptr = reinterpret_cast<const char*>(&_storage);
+    return _engine != NULL && engine_ptr >= storage_ptr && engine_ptr < storage_ptr + InlineSize;
+}
+
+template< typename Uint, std::size_t InlineSize >
+void random_engine_mapper<Uint, InlineSize>::seed(){
+    assert(_engine);
     _engine->map_seed();
+    _buffer_pos = buffer_size;
 }
 
-template< typename Uint >
-void random_engine_mapper<Uint>::seed(result_type seed){
-    assert(_engine.get());
+template< typename Uint, std::size_t InlineSize >
+void random_engine_mapper<Uint, InlineSize>::seed(result_type seed){
+    assert(_engine);
     _engine->map_seed(seed);
+    _buffer_pos = buffer_size;
 }
 
-template< typename Uint >
-typename random_engine_mapper<Uint>::result_type random_engine_mapper<Uint>::operator ()(){
-    assert(_engine.get());
-    return _engine->generate();
+template< typename Uint, std::size_t InlineSize >
+typename random_engine_mapper<Uint, InlineSize>::result_type random_engine_mapper<Uint, InlineSize>::operator ()(){
+    assert(_engine);
+    if(_buffer_pos == buffer_size){
+        _engine->generate(_buffer.data(), buffer_size);
+        _buffer_pos = 0;
+    }
+    return _buffer[_buffer_pos++];
 }
 
-template< typename Uint >
-random_engine_mapper<Uint> random_engine_mapper<Uint>::derivate(result_type key) const{
-    assert(_engine.get());
+template< typename Uint, std::size_t InlineSize >
+void random_engine_mapper<Uint, InlineSize>::fill(result_type* out, std::size_t n){
+    assert(_engine);
+    // buffered values first
+    const std::size_t n_buffered = std::min<std::size_t>(n, buffer_size - _buffer_pos);
+    out = std::copy(_buffer.begin() + _buffer_pos, _buffer.begin() + _buffer_pos + n_buffered, out);
+    _buffer_pos += n_buffered;
+    n -= n_buffered;
+
+    if(n > 0){
+        _engine->generate(out, n);
+    }
+}
+
+template< typename Uint, std::size_t InlineSize >
+random_engine_mapper<Uint, InlineSize> random_engine_mapper<Uint, InlineSize>::derivate(result_type key) const{
+    assert(_engine);
     random_engine_mapper res;
-    res._engine.reset(_engine->derivate(key));
+    res._engine = _engine->derivate(key, res.storage(), InlineSize);
 
     return res;
 }
 
 
+namespace impl{
 
+/// mappers are filled with their buffered bulk path
+template<typename Uint, std::size_t InlineSize>
+inline void engine_generate_n(random_engine_mapper<Uint, InlineSize> & e, Uint* out, std::size_t n){
+    e.fill(out, n);
+}
 
-
+}
 
 
 
@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+#ifndef _HADOKEN_RANDOM_THREEFRY_SIMD_IMPL_HPP_
+#define _HADOKEN_RANDOM_THREEFRY_SIMD_IMPL_HPP_
+
+#include <cstddef>
+#include <limits>
+
+#include <boost/array.hpp>
+
+#include "counter_block_impl.hpp"
+
+
+///
+/// width in bytes of the vector registers targeted by the multi block
+/// threefry kernel: 64 with AVX-512, 32 with AVX2, 16 with SSE2 / NEON
+///
+/// the kernel uses the GCC / clang vector extensions: the compiler maps the lane vectors
+/// on the instruction set enabled at compile time ( e.g -mavx2, -mavx512f, -march=native ).
+/// Other compilers, or HADOKEN_RANDOM_SIMD_WIDTH=0, use a scalar kernel of one lane
+///
+#ifndef HADOKEN_RANDOM_SIMD_WIDTH
+#if !defined(__GNUC__)
+#define HADOKEN_RANDOM_SIMD_WIDTH 0
+#elif defined(__AVX512F__)
+#define HADOKEN_RANDOM_SIMD_WIDTH 64
+#elif defined(__AVX2__)
+#define HADOKEN_RANDOM_SIMD_WIDTH 32
+#elif defined(__SSE2__) || defined(__ARM_NEON) || defined(__ALTIVEC__)
+#define HADOKEN_RANDOM_SIMD_WIDTH 16
+#else
+#define HADOKEN_RANDOM_SIMD_WIDTH 0
+#endif
+#endif
+
+
+namespace hadoken {
+
+namespace impl {
+
+
+#if HADOKEN_RANDOM_SIMD_WIDTH > 0
+
+/// vector of lanes of Uint, one lane per block
+template<typename Uint>
+struct threefry_lane_vector{
+    typedef Uint type __attribute__ ((vector_size (HADOKEN_RANDOM_SIMD_WIDTH)));
+    static const std::size_t lanes = HADOKEN_RANDOM_SIMD_WIDTH / sizeof(Uint);
+
+    static inline type broadcast(Uint v){
+        type res;
+        for(std::size_t l = 0; l < lanes; ++l){
+            res[l] = v;
+        }
+        return res;
+    }
+};
+
+#else
+
+template<typename Uint>
+struct threefry_lane_vector{
+    struct type{
+        Uint v;
+
+        inline Uint & operator[](std::size_t){
+            return v;
+        }
+
+        inline const Uint & operator[](std::size_t) const{
+            return v;
+        }
+
+        inline type & operator+=(const type & o){ v += o.v; return *this; }
+        inline type operator^(const type & o) const{ type r = { v ^ o.v }; return r; }
+        inline type operator|(const type & o) const{ type r = { v | o.v }; return r; }
+        inline type operator<<(unsigned s) const{ type r = { Uint(v << s) }; return r; }
+        inline type operator>>(unsigned s) const{ type r = { Uint(v >> s) }; return r; }
+    };
+
+    static const std::size_t lanes = 1;
+
+    static inline type broadcast(Uint v){
+        type res = { v };
+        return res;
+    }
+};
+
+#endif
+
+
+/// number of blocks encrypted together by the multi block kernel
+template<typename Uint>
+struct threefry_lanes{
+    static const std::size_t value = threefry_lane_vector<Uint>::lanes;
+};
+
+
+template <typename Uint, typename Vector>
+inline Vector simd_rotl(const Vector & x, unsigned s){
+    return (x << s) | (x >> (std::numeric_limits<Uint>::digits - s));
+}
+
+
+///
+/// round r of the threefry rounds applied on several blocks at once,
+/// x[word] holds the word of each block in its lanes
+///
+/// same rounds and key injections as rounds_functor, unrolled at compile time
+///
+template <std::size_t r, std::size_t R, unsigned N, typename Uint, typename Constants>
+struct threefry_multi_round;
+
+
+template <std::size_t r, std::size_t R, typename Uint, typename Constants>
+struct threefry_multi_round<r, R, 4, Uint, Constants>{
+    typedef threefry_lane_vector<Uint> vector_traits;
+    typedef typename vector_traits::type vector_type;
+
+    static inline void apply(const boost::array<Uint, 5> & ks, vector_type (&x)[4]){
+        if(r & 0x01){
+            x[0] += x[3];
+            x[2] += x[1];
+            x[3] = simd_rotl<Uint>(x[3], Constants::rotations0[r % 8]) ^ x[0];
+            x[1] = simd_rotl<Uint>(x[1], Constants::rotations1[r % 8]) ^ x[2];
+        }else{
+            x[0] += x[1];
+            x[2] += x[3];
+            x[1] = simd_rotl<Uint>(x[1], Constants::rotations0[r % 8]) ^ x[0];
+            x[3] = simd_rotl<Uint>(x[3], Constants::rotations1[r % 8]) ^ x[2];
+        }
+
+        if(((r + 1) % 4) == 0){
+            const std::size_t r4 = (r + 1) >> 2;
+            x[0] += vector_traits::broadcast(ks[r4 % 5]);
+            x[1] += vector_traits::broadcast(ks[(r4 + 1) % 5]);
+            x[2] += vector_traits::broadcast(ks[(r4 + 2) % 5]);
+            x[3] += vector_traits::broadcast(ks[(r4 + 3) % 5] + static_cast<Uint>(r4));
+        }
+
+        threefry_multi_round<r + 1, R, 4, Uint, Constants>::apply(ks, x);
+    }
+};
+
+
+template <std::size_t r, std::size_t R, typename Uint, typename Constants>
+struct threefry_multi_round<r, R, 2, Uint, Constants>{
+    typedef threefry_lane_vector<Uint> vector_traits;
+    typedef typename vector_traits::type vector_type;
+
+    static inline void apply(const boost::array<Uint, 3> & ks, vector_type (&x)[2]){
+        x[0] += x[1];
+        x[1] = simd_rotl<Uint>(x[1], Constants::rotations[r % 8]) ^ x[0];
+
+        if(((r + 1) % 4) == 0){
+            const std::size_t r4 = (r + 1) >> 2;
+            x[0] += vector_traits::broadcast(ks[r4 % 3]);
+            x[1] += vector_traits::broadcast(ks[(r4 + 1) % 3] + static_cast<Uint>(r4));
+        }
+
+        threefry_multi_round<r + 1, R, 2, Uint, Constants>::apply(ks, x);
+    }
+};
+
+
+template <std::size_t R, unsigned N, typename Uint, typename Constants>
+struct threefry_multi_round_end{
+    template<typename KeySchedule, typename Vectors>
+    static inline void apply(const KeySchedule &, Vectors &){}
+};
+
+template <std::size_t R, typename Uint, typename Constants>
+struct threefry_multi_round<R, R, 4, Uint, Constants> : public threefry_multi_round_end<R, 4, Uint, Constants>{};
+
+template <std::size_t R, typename Uint, typename Constants>
+struct threefry_multi_round<R, R, 2, Uint, Constants> : public threefry_multi_round_end<R, 2, Uint, Constants>{};
+
+
+///
+/// encrypt the n consecutive counters counter, counter + 1, ..., counter + n - 1 into out,
+/// by groups of threefry_lanes<Uint> blocks. The last group is computed entirely and partially stored
+///
+template <unsigned N, typename Uint, unsigned R, typename Constants>
+inline void threefry_encrypt_blocks(const boost::array<Uint, N+1> & ks, const boost::array<Uint, N> & counter,
+                                    boost::array<Uint, N>* out, std::size_t n){
+    typedef threefry_lane_vector<Uint> vector_traits;
+    typedef typename vector_traits::type vector_type;
+    const std::size_t lanes = vector_traits::lanes;
+
+    boost::array<Uint, N> group_counter(counter);
+    vector_type x[N];
+
+    while(n > 0){
+        // lane l holds the counter group_counter + l, the carry is only possible on the first word
+        // when it wraps inside the group
+        const Uint first_word = group_counter[0];
+        const bool wrap = (first_word > std::numeric_limits<Uint>::max() - static_cast<Uint>(lanes - 1));
+
+        for(std::size_t i = 0; i < N; ++i){
+            x[i] = vector_traits::broadcast(group_counter[i]);
+        }
+        for(std::size_t l = 0; l < lanes; ++l){
+            x[0][l] = first_word + static_cast<Uint>(l);
+        }
+        if(wrap){
+            for(std::size_t l = 0; l < lanes; ++l){
+                boost::array<Uint, N> c(group_counter);
+                counter_add(c, static_cast<Uint>(l));
+                for(std::size_t i = 1; i < N; ++i){
+                    x[i][l] = c[i];
+                }
+            }
+        }
+
+        for(std::size_t i = 0; i < N; ++i){
+            x[i] += vector_traits::broadcast(ks[i]);
+        }
+        threefry_multi_round<0, R, N, Uint, Constants>::apply(ks, x);
+
+        const std::size_t n_group = (n < lanes) ? n : lanes;
+        for(std::size_t l = 0; l < n_group; ++l){
+            for(std::size_t i = 0; i < N; ++i){
+                out[l][i] = x[i][l];
+            }
+        }
+
+        counter_add(group_counter, static_cast<Uint>(lanes));
+        out += n_group;
+        n -= n_group;
+    }
+}
+
+
+} // impl
+
+} // hadoken
+
+#endif // _HADOKEN_RANDOM_THREEFRY_SIMD_IMPL_HPP_
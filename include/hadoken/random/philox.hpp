@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2016, Adrien Devresse <adrien.devresse@epfl.ch>
+ *
+ * Boost Software License - Version 1.0
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+*
+*/
+
+
+//
+// This work is derivated from the boost.Random123
+// repository accessible here https://github.com/DEShawResearch/Random123-Boost
+//
+//
+
+#ifndef _HADOKEN_RANDOM_PHILOX_
+#define _HADOKEN_RANDOM_PHILOX_
+
+#include <algorithm>
+
+#include <boost/array.hpp>
+#include <boost/integer.hpp>
+#include <boost/static_assert.hpp>
+
+#include "impl/counter_block_impl.hpp"
+
+
+///
+///  philox is a state-less counter base random generator
+///  built from a weakened and bijective block cipher:
+///  each round multiplies two words by a constant and mixes
+///  the high half of the product with the key and the other words
+///
+///   philox has been presented at SC11 in the publication
+///
+/// "Parallel random numbers: as easy as 1, 2, 3".
+///    John K. Salmon, Mark A. Moraes, Ron O. Dror, David E. Shaw" (doi:10.1145/2063384.2063405)
+///
+///  This implementation is freely inspired of Boost.Random123  (https://github.com/DEShawResearch/Random123-Boost )
+///
+
+namespace hadoken{
+
+namespace {
+
+// philox_constants is specialized with the multipliers M0, M1
+// and the Weyl sequence increments W0, W1 used for the key schedule
+// of the philox generators, values from Salmon et al.
+//  philox_constants<2, uint32_t>
+//  philox_constants<2, uint64_t>
+//  philox_constants<4, uint32_t>
+//  philox_constants<4, uint64_t>
+template <unsigned _N, typename Uint>
+struct philox_constants{
+};
+
+// 2x32 constants
+template <>
+struct philox_constants<2, uint32_t>{
+    static const uint32_t M0 = UINT32_C(0xD256D193);
+    static const uint32_t W0 = UINT32_C(0x9E3779B9);
+};
+
+// 4x32 constants
+template <>
+struct philox_constants<4, uint32_t>{
+    static const uint32_t M0 = UINT32_C(0xD2511F53);
+    static const uint32_t M1 = UINT32_C(0xCD9E8D57);
+    static const uint32_t W0 = UINT32_C(0x9E3779B9);
+    static const uint32_t W1 = UINT32_C(0xBB67AE85);
+};
+
+// 2x64 constants
+template <>
+struct philox_constants<2, uint64_t>{
+    static const uint64_t M0 = UINT64_C(0xD2B74407B1CE6E93);
+    static const uint64_t W0 = UINT64_C(0x9E3779B97F4A7C15);
+};
+
+// 4x64 constants
+template <>
+struct philox_constants<4, uint64_t>{
+    static const uint64_t M0 = UINT64_C(0xD2E7470EE14C6C93);
+    static const uint64_t M1 = UINT64_C(0xCA5A826395121157);
+    static const uint64_t W0 = UINT64_C(0x9E3779B97F4A7C15);
+    static const uint64_t W1 = UINT64_C(0xBB67AE8584CAA73B);
+};
+
+
+
+/// full product a * b, returned in hi and lo halves
+inline void philox_mulhilo(uint32_t a, uint32_t b, uint32_t & hi, uint32_t & lo){
+    const uint64_t product = static_cast<uint64_t>(a) * static_cast<uint64_t>(b);
+    hi = static_cast<uint32_t>(product >> 32);
+    lo = static_cast<uint32_t>(product);
+}
+
+inline void philox_mulhilo(uint64_t a, uint64_t b, uint64_t & hi, uint64_t & lo){
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128_type;
+    const uint128_type product = static_cast<uint128_type>(a) * static_cast<uint128_type>(b);
+    hi = static_cast<uint64_t>(product >> 64);
+    lo = static_cast<uint64_t>(product);
+#else
+    // portable version by 32 bits half words
+    const uint64_t mask = UINT64_C(0xFFFFFFFF);
+    const uint64_t a_lo = a & mask, a_hi = a >> 32;
+    const uint64_t b_lo = b & mask, b_hi = b >> 32;
+
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t hi_hi = a_hi * b_hi;
+
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & mask) + lo_hi;
+    hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    lo = (cross << 32) | (lo_lo & mask);
+#endif
+}
+
+
+/// the rounds are unrolled at compile time
+/// with the same recursive template approach than the threefry rounds_functor
+template <std::size_t r_remain, typename Uint, typename Domain, typename Key, typename Constants, std::size_t N>
+struct philox_rounds_functor{
+    BOOST_STATIC_ASSERT( N==2 || N==4 );
+};
+
+template <std::size_t r_remain, typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<r_remain, Uint, Domain, Key, Constants, 4>{
+
+    inline void operator() (Key key, Domain & c) const{
+        Uint hi0, lo0, hi1, lo1;
+        philox_mulhilo(Constants::M0, c[0], hi0, lo0);
+        philox_mulhilo(Constants::M1, c[2], hi1, lo1);
+
+        c[0] = hi1 ^ c[1] ^ key[0];
+        c[1] = lo1;
+        c[2] = hi0 ^ c[3] ^ key[1];
+        c[3] = lo0;
+
+        // key schedule: Weyl sequence
+        key[0] += Constants::W0;
+        key[1] += Constants::W1;
+
+        philox_rounds_functor<r_remain-1, Uint, Domain, Key, Constants, 4> func;
+        func(key, c);
+    }
+};
+
+template <typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<0, Uint, Domain, Key, Constants, 4>{
+
+    inline void operator() (const Key & key, Domain & c) const{
+        (void) key;
+        (void) c;
+    }
+};
+
+
+template <std::size_t r_remain, typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<r_remain, Uint, Domain, Key, Constants, 2>{
+
+    inline void operator() (Key key, Domain & c) const{
+        Uint hi, lo;
+        philox_mulhilo(Constants::M0, c[0], hi, lo);
+
+        c[0] = hi ^ c[1] ^ key[0];
+        c[1] = lo;
+
+        // key schedule: Weyl sequence
+        key[0] += Constants::W0;
+
+        philox_rounds_functor<r_remain-1, Uint, Domain, Key, Constants, 2> func;
+        func(key, c);
+    }
+};
+
+template <typename Uint, typename Domain, typename Key, typename Constants>
+struct philox_rounds_functor<0, Uint, Domain, Key, Constants, 2>{
+
+    inline void operator() (const Key & key, Domain & c) const{
+        (void) key;
+        (void) c;
+    }
+};
+
+} // anonymous namespace
+
+
+///
+/// philox counter based random generator of N words of type Uint with R rounds
+///
+/// the key is half the size of the counter
+///
+template <unsigned N, typename Uint, unsigned R=10, typename Constants=philox_constants<N, Uint> >
+class philox{
+    BOOST_STATIC_ASSERT( N==2 || N==4 );
+public:
+    typedef boost::array<Uint, N> domain_type;
+    typedef boost::array<Uint, N> range_type;
+    typedef boost::array<Uint, N/2> key_type;
+    typedef Uint                  uint_type;
+
+    philox() : k(){}
+    philox(key_type _k) : k(_k) {}
+
+    void set_key(key_type _k){
+        k = _k;
+    }
+
+    key_type get_key() const{
+        return k;
+    }
+
+    bool operator==(const philox& rhs) const{
+        return k == rhs.k;
+    }
+
+    bool operator!=(const philox& rhs) const{
+        return k != rhs.k;
+    }
+
+    range_type operator()(const domain_type & counter) const{
+        domain_type c(counter);
+
+        philox_rounds_functor<R, uint_type, domain_type, key_type, Constants, N> func;
+        func(k, c);
+
+        return c;
+    }
+
+    ///
+    /// bulk version: encrypt the n consecutive counters counter, counter + 1, ..., counter + n - 1
+    /// into out, with the same result than n calls to operator()
+    ///
+    void operator()(const domain_type & counter, range_type* out, std::size_t n) const{
+        impl::encrypt_counter_blocks(*this, counter, out, n);
+    }
+
+private:
+    key_type k;
+};
+
+
+
+typedef philox<4, boost::uint32_t> philox4x32;
+typedef philox<2, boost::uint32_t> philox2x32;
+
+typedef philox<4, boost::uint64_t> philox4x64;
+typedef philox<2, boost::uint64_t> philox2x64;
+
+
+}
+
+#endif // _HADOKEN_RANDOM_PHILOX_
@@ -30,12 +30,23 @@
 #ifndef RANDOM_DERIVATE_HPP
 #define RANDOM_DERIVATE_HPP
 
+#include <cstddef>
+
 
 namespace hadoken {
 
 template<typename Engine>
 inline Engine random_engine_derivate(const Engine & engine, const typename Engine::result_type & key );
 
+///
+/// derivate n engines from engine, one for each key of keys:
+/// out[i] = random_engine_derivate(engine, keys[i])
+///
+/// engines with a faster bulk derivation ( counter_engine ) overload it
+///
+template<typename Engine, typename InputIterator, typename OutputIterator>
+inline OutputIterator random_engine_derivate_n(const Engine & engine, InputIterator keys, std::size_t n, OutputIterator out);
+
 
 }
 
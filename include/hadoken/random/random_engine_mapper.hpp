@@ -31,13 +31,15 @@
 
 
 #include <cassert>
+#include <cstddef>
 #include <algorithm>
 #include <vector>
 
 #include <boost/random.hpp>
+#include <boost/array.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/integer.hpp>
-#include <boost/scoped_ptr.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
 
 namespace hadoken {
 
@@ -46,6 +48,8 @@ namespace impl {
 template< typename Uint > class abstract_engine;
 }
 
+template<typename CBRNG> class counter_engine;
+
 
 ///
 /// runtime abstraction layer for the C++11 / boost.Random
@@ -54,8 +58,10 @@ template< typename Uint > class abstract_engine;
 /// Allow to abstract different random generators behind a single
 /// interface at runtime
 ///
+/// The mapped engine is stored inside the mapper when it fits in InlineSize bytes
+/// ( counter engines, tau88, ... ), big engines like mt19937 are allocated on the heap
 ///
-template< typename Uint >
+template< typename Uint, std::size_t InlineSize = 256 >
 class random_engine_mapper {
 public:
 
@@ -74,6 +80,15 @@ public:
 
     inline random_engine_mapper(const random_engine_mapper & other);
 
+    /// move constructor, the moved mapper becomes empty
+    inline random_engine_mapper(random_engine_mapper && other);
+
+    inline ~random_engine_mapper();
+
+    inline random_engine_mapper & operator=(const random_engine_mapper & other);
+
+    inline random_engine_mapper & operator=(random_engine_mapper && other);
+
 
     /// reset to defautl seed, mapping
     inline void seed();
@@ -82,8 +97,15 @@ public:
     inline void seed(result_type seed);
 
     /// generator operation
+    ///
+    /// values are produced by blocks of buffer_size by the mapped engine
+    /// and buffered, the dynamic dispatch happens once per block
     inline result_type operator ()();
 
+    /// fill out with the n next values of the generator,
+    /// with a single dynamic dispatch
+    inline void fill(result_type* out, std::size_t n);
+
     /// derivate create a random engine
     ///  derivated from the current random engine
     ///  seed and the key.
@@ -93,9 +115,14 @@ public:
     ///  - The new random engine do not have statistical correlation with the old one
     ///  - Two different keys, even close in range guarantee two independent random streams
     ///
+    ///  The derivation uses the state of the mapped engine, which is ahead of the values
+    ///  already returned by the number of buffered values
     ///
     inline random_engine_mapper derivate(result_type key) const;
 
+    /// true if the mapped engine is stored inside the mapper
+    inline bool inline_storage() const;
+
     /// minimum value returned by engine
     /// map to minimum value of the type
     static inline result_type min(){
@@ -108,11 +135,35 @@ public:
         return std::numeric_limits<result_type>::max();
     }
     
-private:    
-    boost::scoped_ptr< impl::abstract_engine<result_type> > _engine;
+    /// number of values generated by block by the mapped engine
+    static const std::size_t buffer_size = 16;
+
+    /// size in bytes of the inline storage of the mapped engine
+    static const std::size_t inline_size = InlineSize;
+
+private:
+    inline void reset();
+
+    inline void move_from(random_engine_mapper & other);
+
+    inline void* storage(){
+        return static_cast<void*>(&_storage);
+    }
+
+    typename boost::aligned_storage<InlineSize, alignof(std::max_align_t)>::type _storage;
+    impl::abstract_engine<result_type>* _engine;
+    boost::array<result_type, buffer_size> _buffer;
+    std::size_t _buffer_pos;
 };
 
 
+template< typename Uint, std::size_t InlineSize >
+const std::size_t random_engine_mapper<Uint, InlineSize>::buffer_size;
+
+template< typename Uint, std::size_t InlineSize >
+const std::size_t random_engine_mapper<Uint, InlineSize>::inline_size;
+
+
 typedef random_engine_mapper<boost::uint32_t> random_engine_mapper_32;
 typedef random_engine_mapper<boost::uint64_t> random_engine_mapper_64;
 
@@ -122,8 +173,9 @@ typedef random_engine_mapper<boost::uint64_t> random_engine_mapper_64;
 // specialize random_engine_derivate
 // for random mapper
 
-template <typename Uint>
-inline random_engine_mapper<Uint> random_engine_derivate(const random_engine_mapper<Uint> & engine, const typename random_engine_mapper<Uint>::result_type & key ){
+template <typename Uint, std::size_t InlineSize>
+inline random_engine_mapper<Uint, InlineSize> random_engine_derivate(const random_engine_mapper<Uint, InlineSize> & engine,
+                                                                    const typename random_engine_mapper<Uint, InlineSize>::result_type & key ){
     return engine.derivate(key);
 }
 
@@ -46,6 +46,8 @@
 #include <boost/random/seed_seq.hpp>
 #include <boost/limits.hpp>
 
+#include "impl/threefry_simd_impl.hpp"
+
 
 ///
 ///  threefry is a state-less counter base random generator
@@ -270,33 +272,40 @@ public:
     typedef boost::array<Uint, N> key_type;
     typedef Uint                  uint_type;
 
-    threefry() : k(){}
-    threefry(key_type _k) : k(_k) {}
-    threefry(const threefry& v) : k(v.k){}
+    threefry() : ks(){
+        set_key(key_type());
+    }
+    threefry(key_type _k) : ks(){
+        set_key(_k);
+    }
 
+    ///
+    /// set the key and precompute the extended key schedule,
+    /// the key words followed by their parity with KS_PARITY
+    ///
     void set_key(key_type _k){
-        k = _k;
+        std::copy(_k.begin(), _k.end(), ks.begin());
+        ks[N] = std::accumulate(_k.begin(), _k.end(), Constants::KS_PARITY, std::bit_xor<uint_type>());
     }
 
     key_type get_key() const{
+        key_type k;
+        std::copy(ks.begin(), ks.begin() + N, k.begin());
         return k;
     }
 
     bool operator==(const threefry& rhs) const{
-        return k == rhs.k;
+        return ks == rhs.ks;
     }
 
     bool operator!=(const threefry& rhs) const{
-        return k != rhs.k;
+        return ks != rhs.ks;
     }
 
-    range_type operator()(const domain_type & counter){
-        boost::array<uint_type, N+1>  ks;
+    range_type operator()(const domain_type & counter) const{
         domain_type c(counter);
 
-        std::copy(k.begin(), k.end(), ks.begin());
-        ks[N] = std::accumulate(k.begin(), k.end(), Constants::KS_PARITY, std::bit_xor<uint_type>());
-        std::transform(k.begin(), k.end(), c.begin(), c.begin(), std::plus<uint_type>());
+        std::transform(c.begin(), c.end(), ks.begin(), c.begin(), std::plus<uint_type>());
 
         rounds_functor<R, R, uint_type, domain_type, Constants, N> func;
         func(ks, c);
@@ -304,10 +313,20 @@ public:
         return c;
     }
 
+    ///
+    /// bulk version: encrypt the n consecutive counters counter, counter + 1, ..., counter + n - 1
+    /// into out, with the same result than n calls to operator()
+    ///
+    /// the blocks are encrypted by groups of impl::threefry_lanes<Uint> in vector registers
+    ///
+    void operator()(const domain_type & counter, range_type* out, std::size_t n) const{
+        impl::threefry_encrypt_blocks<N, uint_type, R, Constants>(ks, counter, out, n);
+    }
 
-private:
 
-    key_type k;
+private:
+    // extended key schedule, computed once by set_key
+    boost::array<uint_type, N+1> ks;
 };
 
 
@@ -31,7 +31,10 @@
 
 
 #include <cassert>
+#include <cstdint>
 #include <algorithm>
+#include <iterator>
+#include <memory>
 #include <vector>
 #include <type_traits>
 
@@ -142,6 +145,267 @@ inline Range take_splice(const Range & range, std::size_t slice_id, std::size_t
     return Range(first, last);
 }
 
+
+
+/// size of a cache line in bytes, used to align the range boundaries
+constexpr std::size_t cache_line_size = 64;
+
+
+///
+/// true for the iterators on contiguous memory: pointers and std::vector iterators
+///
+template<typename Iterator, typename Value = typename std::remove_cv<typename std::iterator_traits<Iterator>::value_type>::type,
+         bool is_pointer = std::is_pointer<Iterator>::value>
+struct is_contiguous_iterator : public std::true_type{};
+
+template<typename Iterator, typename Value>
+struct is_contiguous_iterator<Iterator, Value, false> : public std::integral_constant<bool,
+        (std::is_same<Iterator, typename std::vector<Value>::iterator>::value
+         || std::is_same<Iterator, typename std::vector<Value>::const_iterator>::value)
+        && (std::is_same<Value, bool>::value == false)>{};
+
+
+///
+/// \brief alignment of the positions of a contiguous range on memory boundaries
+///
+/// the aligned positions are offset + k * step, step is 1 for the ranges that
+/// can not be aligned: align() is then the identity
+///
+class range_alignment{
+public:
+    inline range_alignment() : offset_(0), step_(1){}
+
+    inline range_alignment(std::size_t offset, std::size_t step) : offset_(offset % step), step_(step){
+        assert(step > 0);
+    }
+
+    /// position of the first aligned element
+    inline std::size_t offset() const{
+        return offset_;
+    }
+
+    /// number of elements between two aligned positions
+    inline std::size_t step() const{
+        return step_;
+    }
+
+    ///
+    /// \brief round pos to the nearest aligned position
+    ///
+    /// 0 and positions after n_elems are kept as is, positions are never rounded up to n_elems:
+    /// rounding the boundaries of consecutive parts keeps a partition of [0, n_elems),
+    /// and the parts of at least 2 * step() elements stay non empty
+    ///
+    inline std::size_t align(std::size_t pos, std::size_t n_elems) const{
+        if(step_ == 1 || pos == 0 || pos >= n_elems){
+            return pos;
+        }
+        // nearest point of the grid offset + (k -1) * step
+        const std::size_t k = (pos + step_ - offset_ + step_ / 2) / step_;
+        if(k == 0){
+            return 0;
+        }
+        const std::size_t aligned_pos = offset_ + (k - 1) * step_;
+        if(aligned_pos >= n_elems){
+            return (k >= 2) ? (aligned_pos - step_) : 0;
+        }
+        return aligned_pos;
+    }
+
+private:
+    std::size_t offset_, step_;
+};
+
+
+namespace{
+
+template<typename Iterator>
+inline range_alignment make_range_alignment(Iterator first, std::size_t n_elems, std::size_t alignment, std::true_type){
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+    const std::size_t elem_size = sizeof(value_type);
+
+    if(n_elems == 0 || elem_size >= alignment || alignment % elem_size != 0){
+        return range_alignment();
+    }
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(std::addressof(*first));
+    if(address % elem_size != 0){
+        return range_alignment();
+    }
+    return range_alignment(((alignment - address % alignment) % alignment) / elem_size, alignment / elem_size);
+}
+
+template<typename Iterator>
+inline range_alignment make_range_alignment(Iterator, std::size_t, std::size_t, std::false_type){
+    return range_alignment();
+}
+
+}
+
+
+///
+/// \brief alignment of the n_elems elements range starting at first on alignment bytes boundaries
+///
+/// only the contiguous ranges of elements smaller than the alignment can be aligned
+///
+template<typename Iterator>
+inline range_alignment make_range_alignment(Iterator first, std::size_t n_elems, std::size_t alignment = cache_line_size){
+    return make_range_alignment(first, n_elems, alignment, is_contiguous_iterator<Iterator>());
+}
+
+
+///
+/// \brief same as take_splice, with the slice boundaries rounded to cache line boundaries
+///
+/// neighbouring slices of a contiguous range do not share any cache line.
+/// Ranges with slices smaller than two cache lines are not aligned
+///
+template<typename Range>
+inline Range take_splice_aligned(const Range & range, std::size_t slice_id, std::size_t total_slices,
+                                 std::size_t alignment = cache_line_size){
+    assert(slice_id <= total_slices);
+    const std::size_t n_elem = range.size();
+    const std::size_t elem_per_slice_base = n_elem / total_slices;
+    const std::size_t elem_per_slice_modulo = n_elem % total_slices;
+
+    range_alignment align = make_range_alignment(range.begin(), n_elem, alignment);
+    if(elem_per_slice_base < 2 * align.step()){
+        align = range_alignment();
+    }
+
+    const std::size_t pos_first = std::min(n_elem, elem_per_slice_base * slice_id + std::min(elem_per_slice_modulo, slice_id));
+    const std::size_t pos_last = std::min(n_elem, pos_first + elem_per_slice_base + ((slice_id < elem_per_slice_modulo) ? 1 : 0));
+
+    typename Range::iterator_type first = range.begin();
+    std::advance(first, align.align(pos_first, n_elem));
+
+    typename Range::iterator_type last = range.begin();
+    std::advance(last, align.align(pos_last, n_elem));
+
+    return Range(first, last);
+}
+
+
+///
+/// \brief same as split_range, with the part boundaries rounded to cache line boundaries
+///
+template<typename Range>
+inline std::vector<Range> split_range_aligned(const Range & range, std::size_t number_parts,
+                                              std::size_t alignment = cache_line_size){
+    assert(number_parts > 0);
+
+    std::vector<Range> ranges;
+    ranges.reserve(number_parts);
+    for(std::size_t i = 0; i < number_parts; ++i){
+        ranges.push_back(take_splice_aligned(range, i, number_parts, alignment));
+    }
+    return ranges;
+}
+
+
+
+///
+/// \brief two dimensional range [rows_begin, rows_end) x [cols_begin, cols_end)
+///  cut in tiles of row_grain x col_grain
+///
+/// the bounds can be integral indices or random access iterators,
+/// tiles are numbered in row major order, tile(i) is itself a blocked_range2d
+///
+template <typename RowValue, typename ColValue = RowValue>
+class blocked_range2d{
+public:
+    typedef RowValue row_type;
+    typedef ColValue col_type;
+    typedef blocked_range2d<RowValue, ColValue> range_type;
+
+    inline blocked_range2d(const row_type & rows_first, const row_type & rows_last,
+                           const col_type & cols_first, const col_type & cols_last,
+                           std::size_t row_grain = 64, std::size_t col_grain = 64) :
+        rows_first_(rows_first), rows_last_(rows_last), cols_first_(cols_first), cols_last_(cols_last),
+        row_grain_(std::max<std::size_t>(row_grain, 1)), col_grain_(std::max<std::size_t>(col_grain, 1)){
+        assert(!(rows_last < rows_first));
+        assert(!(cols_last < cols_first));
+    }
+
+    inline const row_type & rows_begin() const{
+        return rows_first_;
+    }
+
+    inline const row_type & rows_end() const{
+        return rows_last_;
+    }
+
+    inline const col_type & cols_begin() const{
+        return cols_first_;
+    }
+
+    inline const col_type & cols_end() const{
+        return cols_last_;
+    }
+
+    inline std::size_t n_rows() const{
+        return static_cast<std::size_t>(rows_last_ - rows_first_);
+    }
+
+    inline std::size_t n_cols() const{
+        return static_cast<std::size_t>(cols_last_ - cols_first_);
+    }
+
+    inline std::size_t row_grain() const{
+        return row_grain_;
+    }
+
+    inline std::size_t col_grain() const{
+        return col_grain_;
+    }
+
+    /// number of tiles along the rows and along the columns
+    inline std::size_t row_tiles() const{
+        return (n_rows() + row_grain_ - 1) / row_grain_;
+    }
+
+    inline std::size_t col_tiles() const{
+        return (n_cols() + col_grain_ - 1) / col_grain_;
+    }
+
+    ///
+    /// \brief size
+    /// \return number of tiles
+    ///
+    inline std::size_t size() const{
+        return row_tiles() * col_tiles();
+    }
+
+    /// tile tile_id, in row major order
+    inline range_type tile(std::size_t tile_id) const{
+        const std::size_t row_first = (tile_id / col_tiles()) * row_grain_;
+        const std::size_t col_first = (tile_id % col_tiles()) * col_grain_;
+        const std::size_t row_last = std::min(n_rows(), row_first + row_grain_);
+        const std::size_t col_last = std::min(n_cols(), col_first + col_grain_);
+
+        return range_type(advance_value(rows_first_, row_first), advance_value(rows_first_, row_last),
+                          advance_value(cols_first_, col_first), advance_value(cols_first_, col_last),
+                          row_grain_, col_grain_);
+    }
+
+    bool operator==(const range_type & other) const{
+        return (rows_first_ == other.rows_first_) && (rows_last_ == other.rows_last_)
+                && (cols_first_ == other.cols_first_) && (cols_last_ == other.cols_last_);
+    }
+
+private:
+    template<typename Value>
+    static inline Value advance_value(const Value & v, std::size_t n){
+        typedef decltype(v - v) difference_type;
+        return v + static_cast<difference_type>(n);
+    }
+
+    row_type rows_first_, rows_last_;
+    col_type cols_first_, cols_last_;
+    std::size_t row_grain_, col_grain_;
+};
+
+
 }
 
 #endif // RANGE_HPP
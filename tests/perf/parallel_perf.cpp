@@ -182,6 +182,8 @@ int main(){
     parallel_mode = "openmp";
 #elif (defined HADOKEN_PARALLEL_USE_TBB)
     parallel_mode = "tbb";
+#elif (defined HADOKEN_PARALLEL_USE_PSTL)
+    parallel_mode = "std_execution";
 #else
     parallel_mode = "pthread";
 #endif
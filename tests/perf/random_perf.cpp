@@ -36,6 +36,9 @@
 #include <boost/random.hpp>
 #include <boost/chrono.hpp>
 
+#include <string>
+#include <vector>
+
 #include <hadoken/random/random.hpp>
 
 
@@ -261,6 +264,236 @@ std::size_t test_random_threefry(std::size_t iter){
 }
 
 
+std::size_t test_random_philox(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+
+    hadoken::counter_engine<hadoken::philox4x32> philox_engine;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        res += dist(philox_engine);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << "philox4x32: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+std::size_t test_random_philox2x64(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+
+    hadoken::counter_engine<hadoken::philox2x64> philox_engine;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        res += dist(philox_engine);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << "philox2x64: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+std::size_t test_random_philox_generate(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<hadoken::philox2x64> philox_engine;
+    std::vector<boost::uint64_t> values(iter);
+
+    t1 = cl::now();
+
+    philox_engine.fill(values.data(), values.size());
+
+    t2 = cl::now();
+
+    std::cout << "philox2x64_fill_bulk: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    return res;
+}
+
+
+std::size_t test_random_ars(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+
+    hadoken::counter_engine<hadoken::ars4x32> ars_engine;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        res += dist(ars_engine);
+    }
+
+
+    t2 = cl::now();
+
+    std::cout << "ars4x32 (aesni " << HADOKEN_RANDOM_AESNI << "): " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
+std::size_t test_random_ars_generate(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<hadoken::ars4x32> ars_engine;
+    std::vector<boost::uint32_t> values(iter * 2);
+
+    t1 = cl::now();
+
+    ars_engine.fill(values.data(), values.size());
+
+    t2 = cl::now();
+
+    std::cout << "ars4x32_fill_bulk (same bytes than threefry_fill_bulk): " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    return res;
+}
+
+
+std::size_t test_random_threefry_blocks(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::threefry4x64 threefry_cipher;
+    hadoken::threefry4x64::domain_type counter = {{ 0, 0, 0, 0 }};
+
+    const std::size_t n_blocks = iter / counter.size();
+    std::vector<hadoken::threefry4x64::range_type> blocks(n_blocks);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < n_blocks; ++i){
+        counter[0] = i;
+        blocks[i] = threefry_cipher(counter);
+    }
+
+    t2 = cl::now();
+
+    std::cout << "threefry_blocks_scalar: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += blocks[n_blocks / 2][0];
+
+    counter[0] = 0;
+
+    t1 = cl::now();
+
+    threefry_cipher(counter, blocks.data(), n_blocks);
+
+    t2 = cl::now();
+
+    std::cout << "threefry_blocks_bulk (" << hadoken::impl::threefry_lanes<boost::uint64_t>::value << " lanes): "
+              << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += blocks[n_blocks / 2][0];
+
+    return res;
+}
+
+
+std::size_t test_random_threefry_generate(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<hadoken::threefry4x64> threefry_engine;
+    std::vector<boost::uint64_t> values(iter);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        values[i] = threefry_engine();
+    }
+
+    t2 = cl::now();
+
+    std::cout << "threefry_fill_loop: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    t1 = cl::now();
+
+    threefry_engine.fill(values.data(), values.size());
+
+    t2 = cl::now();
+
+    std::cout << "threefry_fill_bulk: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    return res;
+}
+
+
+template<typename Distribution, typename BulkDistribution>
+double test_random_distribution(const std::string & name, std::size_t iter){
+
+    double res =0;
+
+    tp t1, t2;
+
+    hadoken::counter_engine<hadoken::threefry4x64> threefry_engine;
+    std::vector<double> values(iter);
+
+    Distribution dist;
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        values[i] = dist(threefry_engine);
+    }
+
+    t2 = cl::now();
+
+    std::cout << "threefry_" << name << "_boost: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    BulkDistribution bulk_dist;
+
+    t1 = cl::now();
+
+    bulk_dist.generate(threefry_engine, values.begin(), values.end());
+
+    t2 = cl::now();
+
+    std::cout << "threefry_" << name << "_bulk: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += values[iter / 2];
+
+    return res;
+}
+
+
 int main(){
 
     const std::size_t n_exec = 10000000;
@@ -291,6 +524,37 @@ int main(){
 
     junk += test_random_abstract_threefry(n_exec);
 
-    std::cout << "end junk " << junk << std::endl;
+
+    junk += test_random_philox(n_exec);
+
+
+    junk += test_random_philox2x64(n_exec);
+
+
+    junk += test_random_ars(n_exec);
+
+
+    junk += test_random_threefry_blocks(n_exec);
+
+
+    junk += test_random_threefry_generate(n_exec);
+
+
+    junk += test_random_philox_generate(n_exec);
+
+
+    junk += test_random_ars_generate(n_exec);
+
+    double junk_real = 0;
+
+    junk_real += test_random_distribution<boost::random::uniform_01<double>, hadoken::uniform01<double> >("uniform01", n_exec);
+
+
+    junk_real += test_random_distribution<boost::random::normal_distribution<double>, hadoken::normal_distribution<double> >("normal", n_exec);
+
+
+    junk_real += test_random_distribution<boost::random::exponential_distribution<double>, hadoken::exponential_distribution<double> >("exponential", n_exec);
+
+    std::cout << "end junk " << junk << " " << junk_real << std::endl;
 
 }
@@ -269,6 +269,47 @@ std::size_t test_random_threefry(std::size_t iter){
 }
 
 
+std::size_t test_random_threefry_derivate_n(std::size_t iter){
+
+    std::size_t res =0;
+
+    tp t1, t2;
+
+    boost::random::uniform_int_distribution<std::size_t> dist;
+
+    hadoken::counter_engine<hadoken::threefry4x64> threefry_engine;
+
+    std::vector<boost::uint64_t> keys(iter);
+    for(std::size_t i =0; i < iter; ++i){
+        keys[i] = i;
+    }
+    std::vector<hadoken::counter_engine<hadoken::threefry4x64> > derivated_engines(iter);
+
+    t1 = cl::now();
+
+    for(std::size_t i =0; i < iter; ++i){
+        derivated_engines[i] = hadoken::random_engine_derivate(threefry_engine, keys[i]);
+    }
+
+    t2 = cl::now();
+
+    std::cout << "threefry_derivate_loop: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    res += dist(derivated_engines[iter / 2]);
+
+    t1 = cl::now();
+
+    hadoken::random_engine_derivate_n(threefry_engine, keys.begin(), iter, derivated_engines.begin());
+
+    t2 = cl::now();
+
+    res += dist(derivated_engines[iter / 2]);
+
+    std::cout << "threefry_derivate_n: " << boost::chrono::duration_cast<milliseconds>(t2 -t1) << std::endl;
+    return res;
+
+}
+
+
 int main(){
 
     const std::size_t n_exec = 1000000;
@@ -299,6 +340,9 @@ int main(){
 
     junk += test_random_abstract_threefry(n_exec);
 
+
+    junk += test_random_threefry_derivate_n(n_exec);
+
     std::cout << "end junk " << junk << std::endl;
 
 }
@@ -33,6 +33,8 @@
 #include <iostream>
 #include <map>
 #include <stdexcept>
+#include <list>
+#include <cstdint>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/mpl/list.hpp>
@@ -200,3 +202,103 @@ void  test_check_range(T vec, size_t partition, const Mod & modifier, const Chec
     }
 
 }
+
+
+
+template<typename T>
+void check_split_range_aligned(const std::vector<T> & vec, std::size_t partition){
+    using namespace hadoken;
+
+    typedef range<typename std::vector<T>::const_iterator> range_vec;
+    const range_vec my_range(vec.begin(), vec.end());
+
+    std::vector<range_vec> ranges = split_range_aligned(my_range, partition);
+    BOOST_CHECK_EQUAL(ranges.size(), partition);
+    BOOST_CHECK(ranges.front().begin() == vec.begin());
+    BOOST_CHECK(ranges.back().end() == vec.end());
+
+    const bool aligned = (vec.size() / partition) >= 2 * (cache_line_size / sizeof(T));
+    for(std::size_t i = 0; i < partition; ++i){
+        BOOST_CHECK(ranges[i] == take_splice_aligned(my_range, i, partition));
+
+        // the parts are contiguous and start on a cache line
+        if(i > 0){
+            BOOST_CHECK(ranges[i - 1].end() == ranges[i].begin());
+            if(aligned){
+                BOOST_CHECK(ranges[i].size() > 0);
+                if(ranges[i].begin() != vec.end()){
+                    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(&*ranges[i].begin()) % cache_line_size, 0);
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( range_split_aligned_test)
+{
+    using namespace hadoken;
+
+    BOOST_CHECK(is_contiguous_iterator<int*>::value);
+    BOOST_CHECK(is_contiguous_iterator<std::vector<float>::iterator>::value);
+    BOOST_CHECK(is_contiguous_iterator<std::vector<float>::const_iterator>::value);
+    BOOST_CHECK(is_contiguous_iterator<std::list<float>::iterator>::value == false);
+    BOOST_CHECK(is_contiguous_iterator<std::vector<bool>::iterator>::value == false);
+
+    for(std::size_t size : { 0, 1, 63, 1000, 100003 }){
+        for(std::size_t partition : { 1, 3, 16, 200 }){
+            check_split_range_aligned(std::vector<char>(size), partition);
+            check_split_range_aligned(std::vector<float>(size), partition);
+            check_split_range_aligned(std::vector<double>(size), partition);
+        }
+    }
+
+    // non contiguous ranges are split as split_range
+    std::list<int> l(1000);
+    range<std::list<int>::iterator> l_range(l.begin(), l.end());
+    BOOST_CHECK(split_range_aligned(l_range, 7) == split_range(l_range, 7));
+
+    // alignment grid
+    const range_alignment align(3, 16);
+    BOOST_CHECK_EQUAL(align.align(0, 100), 0);
+    BOOST_CHECK_EQUAL(align.align(5, 100), 3);
+    BOOST_CHECK_EQUAL(align.align(12, 100), 19);
+    BOOST_CHECK_EQUAL(align.align(98, 100), 99);
+    BOOST_CHECK_EQUAL(align.align(98, 99), 83);
+    BOOST_CHECK_EQUAL(align.align(100, 100), 100);
+    BOOST_CHECK_EQUAL(range_alignment().align(42, 100), 42);
+}
+
+
+BOOST_AUTO_TEST_CASE( blocked_range2d_test)
+{
+    using namespace hadoken;
+
+    const blocked_range2d<int> r(2, 102, -5, 40, 32, 16);
+    BOOST_CHECK_EQUAL(r.n_rows(), 100);
+    BOOST_CHECK_EQUAL(r.n_cols(), 45);
+    BOOST_CHECK_EQUAL(r.row_tiles(), 4);
+    BOOST_CHECK_EQUAL(r.col_tiles(), 3);
+    BOOST_CHECK_EQUAL(r.size(), 12);
+
+    // tiles cover each cell exactly once
+    std::vector<int> coverage(r.n_rows() * r.n_cols(), 0);
+    for(std::size_t t = 0; t < r.size(); ++t){
+        const blocked_range2d<int> tile = r.tile(t);
+        BOOST_CHECK(tile.n_rows() <= 32 && tile.n_cols() <= 16);
+        for(int i = tile.rows_begin(); i < tile.rows_end(); ++i){
+            for(int j = tile.cols_begin(); j < tile.cols_end(); ++j){
+                coverage[(i - 2) * r.n_cols() + (j + 5)] += 1;
+            }
+        }
+    }
+    BOOST_CHECK(std::all_of(coverage.begin(), coverage.end(), [](int c){ return c == 1; }));
+    BOOST_CHECK(r.tile(r.size() - 1) == blocked_range2d<int>(98, 102, 27, 40));
+
+    // iterator bounds
+    std::vector<double> rows(10), cols(7);
+    const blocked_range2d<std::vector<double>::iterator> it_range(rows.begin(), rows.end(), cols.begin(), cols.end(), 4, 4);
+    BOOST_CHECK_EQUAL(it_range.size(), 6);
+    BOOST_CHECK(it_range.tile(5).rows_begin() == rows.begin() + 8);
+    BOOST_CHECK(it_range.tile(5).cols_end() == cols.end());
+}
@@ -39,10 +39,21 @@
 #include <numeric>
 
 #include <chrono>
+#include <atomic>
+#include <set>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <cmath>
+#include <cstring>
+#include <functional>
 
 #include <boost/test/unit_test.hpp>
 
 #include <hadoken/parallel/algorithm.hpp>
+#include <hadoken/executor/thread_pool_executor.hpp>
+#include <hadoken/random/random.hpp>
 
 //#include <parallel/algorithm>
 
@@ -152,6 +163,147 @@ BOOST_AUTO_TEST_CASE( parallel_for_each_nested)
 
 
 
+template<typename Policy>
+std::size_t count_chunks_and_check(const Policy & policy, std::size_t n){
+    std::vector<int> values(n, 0);
+    std::atomic<std::size_t> n_chunks(0);
+
+    parallel::for_range(policy, values.begin(), values.end(), [&](std::vector<int>::iterator first, std::vector<int>::iterator last){
+        n_chunks++;
+        BOOST_CHECK(first < last);
+        std::for_each(first, last, [](int & v){ v += 1; });
+    });
+
+    // every element processed exactly once
+    BOOST_CHECK(std::all_of(values.begin(), values.end(), [](int v){ return v == 1; }));
+    return n_chunks.load();
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_execution_options_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100000;
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::chunks(7)), n), 7);
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::grain(1000)), n), 100);
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::grain(999)), n), 101);
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::dynamic, parallel::grain(300)), n), 334);
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par_vec.with(parallel::dynamic).with(parallel::chunks(10)), n), 10);
+
+    BOOST_CHECK_GE(count_chunks_and_check(parallel::par.with(parallel::guided, parallel::grain(64)), n), 1);
+
+    BOOST_CHECK_GE(count_chunks_and_check(parallel::par.with(parallel::dynamic), n), 1);
+
+    // more chunks than elements
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::chunks(64)), 10), 10);
+
+    // small range executed sequentially
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::chunks(64), parallel::sequential_threshold(n+1)), n), 1);
+
+    // empty range
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::dynamic), 0), 0);
+
+    // options are propagated to the algorithms
+    std::vector<int> values(n);
+    std::iota(values.begin(), values.end(), 0);
+    BOOST_CHECK(parallel::find(parallel::par.with(parallel::guided), values.begin(), values.end(), 4242) == values.begin() + 4242);
+    BOOST_CHECK(parallel::find(parallel::par.with(parallel::chunks(128)), values.begin(), values.end(), 77777) == values.begin() + 77777);
+    BOOST_CHECK_EQUAL(parallel::count(parallel::par.with(parallel::dynamic, parallel::grain(10)), values.begin(), values.end(), 42), 1);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_executor_policy_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100000;
+
+    thread_pool_executor pool(3);
+
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.on(pool), n), 3);
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.on(pool).with(parallel::chunks(17)), n), 17);
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::dynamic, parallel::grain(1000)).on(pool), n), 100);
+
+    // chunks are executed by the pool workers
+    std::set<std::thread::id> workers;
+    std::mutex workers_lock;
+    std::vector<int> values(64, 0);
+
+    parallel::for_each(parallel::par.on(pool).with(parallel::chunks(64)), values.begin(), values.end(), [&](int & v){
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> l(workers_lock);
+        workers.insert(std::this_thread::get_id());
+        v = 1;
+    });
+
+    BOOST_CHECK_EQUAL(std::count(values.begin(), values.end(), 1), 64);
+    BOOST_CHECK_GT(workers.size(), 1);
+
+    // nested algorithms on the same pool
+    std::vector<std::vector<double> > vec_vec_values(64, std::vector<double>(1024, 1.0));
+
+    parallel::for_each(parallel::par.on(pool), vec_vec_values.begin(), vec_vec_values.end(), [&pool](std::vector<double> & vec_values){
+        parallel::for_each(parallel::par.on(pool).with(parallel::chunks(8)), vec_values.begin(), vec_values.end(), []( double & v){
+           v += 42;
+        });
+    });
+
+    for(auto & vec_values : vec_vec_values){
+        BOOST_CHECK(parallel::all_of(parallel::par_vec.on(pool), vec_values.begin(), vec_values.end(), [](double v){ return v == 43.0; }));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_for_range_fused_test)
+{
+    using namespace hadoken;
+    using iterator = std::vector<std::size_t>::iterator;
+
+    const std::size_t n = 100000;
+
+    std::vector<std::size_t> values(n), shifted(n);
+
+    auto run_fused = [&](const parallel::parallel_execution_policy & policy){
+        std::fill(values.begin(), values.end(), 0);
+
+        parallel::for_range_fused(policy, values.begin(), values.end(),
+            // stage 1: iota
+            [&](iterator first, iterator last){
+                for(; first < last; ++first){
+                    *first = std::distance(values.begin(), first);
+                }
+            },
+            // stage 2: read the neighbour, possibly produced by an other chunk of stage 1
+            [&](iterator first, iterator last){
+                for(; first < last; ++first){
+                    const std::size_t pos = std::distance(values.begin(), first);
+                    shifted[pos] = values[(pos + 1) % n];
+                }
+            }
+        );
+
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK_EQUAL(values[i], i);
+            BOOST_CHECK_EQUAL(shifted[i], (i+1) % n);
+        }
+    };
+
+    run_fused(parallel::par);
+    run_fused(parallel::par.with(parallel::chunks(13)));
+    run_fused(parallel::par.with(parallel::dynamic, parallel::grain(100)));
+    run_fused(parallel::par.with(parallel::guided));
+}
+
+
+
 BOOST_AUTO_TEST_CASE( parallel_fill_test)
 {
 
@@ -180,6 +332,13 @@ BOOST_AUTO_TEST_CASE( parallel_fill_test)
     BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), values_par.begin(),values_par.end());
     BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), values_par_n.begin(),values_par_n.end());
 
+    std::vector<int> values_vec(n + 3, 0);
+    parallel::fill(parallel::par_vec.with(parallel::chunks(7)), values_vec.begin() + 1, values_vec.end() - 2, 3);
+
+    BOOST_CHECK_EQUAL(values_vec.front(), 0);
+    BOOST_CHECK_EQUAL(std::count(values_vec.begin(), values_vec.end(), 3), n);
+    BOOST_CHECK_EQUAL(values_vec.back(), 0);
+
 }
 
 
@@ -237,6 +396,13 @@ BOOST_AUTO_TEST_CASE( parallel_count_test)
     BOOST_CHECK_EQUAL(num_2, p_num_2);
     BOOST_CHECK_EQUAL(num_2, s_num_2);
 
+    // vectorised chunks
+    auto vec_policy = parallel::par_vec.with(parallel::chunks(8));
+    BOOST_CHECK_EQUAL(num_4, std::size_t(parallel::count(vec_policy, values.begin(), values.end(), 4)));
+    BOOST_CHECK_EQUAL(num_2, std::size_t(parallel::count_if(vec_policy, values.begin(), values.end(), [&](const std::size_t & v){
+        return v == 1;
+    })));
+
     std::cout << " n " << s_num_4 << std::endl;
 }
 
@@ -304,6 +470,18 @@ BOOST_AUTO_TEST_CASE( parallel_transform_test)
 
     BOOST_CHECK_EQUAL_COLLECTIONS(res2.begin(), res2.end(), res4.begin(), res4.end());
 
+    // vectorised chunks
+    std::vector<std::size_t> res_vec(n), res_vec_unary(n);
+    auto vec_policy = parallel::par_vec.with(parallel::chunks(8));
+
+    hadoken::parallel::transform(vec_policy, v1.begin(), v1.end(), v2.begin(), res_vec.begin(), dummy_ops);
+    hadoken::parallel::transform(vec_policy, v1.begin(), v1.end(), res_vec_unary.begin(), [](const std::size_t & v){
+        return v + 100;
+    });
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(res_vec.begin(), res_vec.end(), res3.begin(), res3.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(res_vec_unary.begin(), res_vec_unary.end(), res4.begin(), res4.end());
+
 }
 
 
@@ -536,6 +714,67 @@ BOOST_AUTO_TEST_CASE( parallel_any_of_test)
 }
 
 
+BOOST_AUTO_TEST_CASE( parallel_find_test)
+{
+
+    using namespace hadoken;
+
+    std::size_t n = 5000000;
+
+    std::vector<int> values(n);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto is_negative = [](int v){
+            return (v <0);
+    };
+
+    // nothing to find
+    BOOST_CHECK(parallel::find(parallel::par, values.begin(), values.end(), -1) == values.end());
+    BOOST_CHECK(parallel::find_if(parallel::par, values.begin(), values.end(), is_negative) == values.end());
+
+    std::vector<int> empty_values;
+    BOOST_CHECK(parallel::find(parallel::par, empty_values.begin(), empty_values.end(), 42) == empty_values.end());
+
+    // several matches, the first one need to be returned
+    values[n/2] = -1;
+    values[n -1] = -1;
+    values[12] = -1;
+
+    {
+        auto t1 = cl::now();
+        auto it = parallel::find_if(parallel::par, values.begin(), values.end(), is_negative);
+        auto t2 = cl::now();
+
+        std::cout << " find_if early parallel " << std::chrono::duration_cast<std::chrono::microseconds>(t2 -t1).count() << std::endl;
+
+        BOOST_CHECK_EQUAL(std::distance(values.begin(), it), 12);
+    }
+
+    BOOST_CHECK(parallel::find(parallel::par, values.begin(), values.end(), -1) == values.begin() + 12);
+    BOOST_CHECK(parallel::find(parallel::seq, values.begin(), values.end(), -1) == values.begin() + 12);
+
+    values[12] = 12;
+
+    BOOST_CHECK(parallel::find(parallel::par, values.begin(), values.end(), -1) == values.begin() + n/2);
+    BOOST_CHECK(parallel::find(parallel::par_vec, values.begin(), values.end(), 42) == values.begin() + 42);
+
+
+    std::vector<int> needles = { -5, 4000000, 3000000 };
+
+    auto it_par = parallel::find_first_of(parallel::par, values.begin(), values.end(), needles.begin(), needles.end());
+    auto it_seq = parallel::find_first_of(parallel::seq, values.begin(), values.end(), needles.begin(), needles.end());
+    auto it_std = std::find_first_of(values.begin(), values.end(), needles.begin(), needles.end());
+
+    BOOST_CHECK(it_par == it_std);
+    BOOST_CHECK(it_seq == it_std);
+    BOOST_CHECK_EQUAL(*it_par, 3000000);
+
+    auto it_pred = parallel::find_first_of(parallel::par, values.begin(), values.end(), needles.begin(), needles.end(),
+                                                [](int v, int needle){ return v == needle + 1; });
+    BOOST_CHECK_EQUAL(*it_pred, 3000001);
+}
+
+
 template<typename Container>
 bool is_ordered(Container & c){
     for(std::size_t i =0; i < c.size()-1; ++i){
@@ -671,3 +910,885 @@ BOOST_AUTO_TEST_CASE( parallel_inclusive_scan)
   
 
 }
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_reduce_test)
+{
+
+    using namespace hadoken;
+
+    const std::size_t n = 1000003;
+
+    std::vector<std::uint64_t> values(n);
+    std::iota(values.begin(), values.end(), 1);
+
+    const std::uint64_t sum = std::accumulate(values.begin(), values.end(), std::uint64_t(0));
+
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::seq, values.begin(), values.end()), sum);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, values.begin(), values.end()), sum);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par.with(parallel::chunks(13)), values.begin(), values.end()), sum);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec.with(parallel::chunks(13)), values.begin(), values.end()), sum);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec.with(parallel::dynamic), values.begin(), values.end(), std::uint64_t(10)), sum + 10);
+
+    // non additive operation
+    auto max_op = [](std::uint64_t v1, std::uint64_t v2){
+        return std::max(v1, v2);
+    };
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec.with(parallel::chunks(13)), values.begin(), values.end(), std::uint64_t(0), max_op), n);
+
+    // floating point, exact with integral values
+    std::vector<double> dvalues(n, 0.5);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec.with(parallel::chunks(5)), dvalues.begin(), dvalues.end(), 0.0), n * 0.5);
+
+    // empty range
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par, values.begin(), values.begin(), std::uint64_t(42)), 42);
+
+    // empty range below the sequential threshold
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par.with(parallel::sequential_threshold(100)), dvalues.end(), dvalues.end(), 5.0), 5.0);
+    BOOST_CHECK_EQUAL(parallel::reduce(parallel::par_vec.with(parallel::sequential_threshold(100)), dvalues.end(), dvalues.end(), 5.0), 5.0);
+
+    std::size_t n_calls = 0;
+    parallel::for_range(parallel::par.with(parallel::sequential_threshold(100)), dvalues.end(), dvalues.end(),
+                        [&](std::vector<double>::iterator, std::vector<double>::iterator){ ++n_calls; });
+    BOOST_CHECK_EQUAL(n_calls, 0);
+
+}
+
+
+
+template<typename Policy>
+void check_compaction(const Policy & policy, const std::vector<int> & values){
+    using namespace hadoken;
+
+    auto is_odd = [](int v){
+        return (v % 2) != 0;
+    };
+
+    // copy
+    {
+        std::vector<int> res(values.size());
+        BOOST_CHECK(parallel::copy(policy, values.begin(), values.end(), res.begin()) == res.end());
+        BOOST_CHECK(res == values);
+
+        // output iterators fall back to the sequential algorithm
+        std::vector<int> res_back;
+        parallel::copy(policy, values.begin(), values.end(), std::back_inserter(res_back));
+        BOOST_CHECK(res_back == values);
+    }
+
+    // copy_if / remove_copy_if
+    {
+        std::vector<int> expected, res(values.size()), res_remove(values.size());
+        std::copy_if(values.begin(), values.end(), std::back_inserter(expected), is_odd);
+
+        auto res_end = parallel::copy_if(policy, values.begin(), values.end(), res.begin(), is_odd);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res.begin(), res_end, expected.begin(), expected.end());
+
+        std::vector<int> res_back;
+        parallel::copy_if(policy, values.begin(), values.end(), std::back_inserter(res_back), is_odd);
+        BOOST_CHECK(res_back == expected);
+
+        std::vector<int> expected_remove;
+        std::remove_copy_if(values.begin(), values.end(), std::back_inserter(expected_remove), is_odd);
+        auto res_remove_end = parallel::remove_copy_if(policy, values.begin(), values.end(), res_remove.begin(), is_odd);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_remove.begin(), res_remove_end, expected_remove.begin(), expected_remove.end());
+    }
+
+    // remove_if
+    {
+        std::vector<int> expected(values), res(values);
+        expected.erase(std::remove_if(expected.begin(), expected.end(), is_odd), expected.end());
+        res.erase(parallel::remove_if(policy, res.begin(), res.end(), is_odd), res.end());
+        BOOST_CHECK(res == expected);
+    }
+
+    // partition and partition_copy, stable
+    {
+        std::vector<int> expected(values), res(values);
+        auto expected_middle = std::stable_partition(expected.begin(), expected.end(), is_odd);
+        auto middle = parallel::partition(policy, res.begin(), res.end(), is_odd);
+
+        BOOST_CHECK_EQUAL(std::distance(expected.begin(), expected_middle), std::distance(res.begin(), middle));
+        BOOST_CHECK(res == expected);
+
+        std::vector<int> res_true(values.size()), res_false(values.size());
+        auto ends = parallel::partition_copy(policy, values.begin(), values.end(), res_true.begin(), res_false.begin(), is_odd);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_true.begin(), ends.first, expected.begin(), expected_middle);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_false.begin(), ends.second, expected_middle, expected.end());
+
+        std::vector<int> res_true_back, res_false_back;
+        parallel::partition_copy(policy, values.begin(), values.end(), std::back_inserter(res_true_back),
+                                 std::back_inserter(res_false_back), is_odd);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_true_back.begin(), res_true_back.end(), expected.begin(), expected_middle);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_false_back.begin(), res_false_back.end(), expected_middle, expected.end());
+    }
+
+    // unique and unique_copy
+    {
+        std::vector<int> expected(values), res(values), res_copy(values.size());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        res.erase(parallel::unique(policy, res.begin(), res.end()), res.end());
+        BOOST_CHECK(res == expected);
+
+        auto res_copy_end = parallel::unique_copy(policy, values.begin(), values.end(), res_copy.begin());
+        BOOST_CHECK_EQUAL_COLLECTIONS(res_copy.begin(), res_copy_end, expected.begin(), expected.end());
+
+        std::vector<int> res_back;
+        parallel::unique_copy(policy, values.begin(), values.end(), std::back_inserter(res_back));
+        BOOST_CHECK(res_back == expected);
+    }
+}
+
+
+// value type without default constructor
+struct no_default_int{
+    explicit no_default_int(int v) : value(v){}
+
+    int value;
+};
+
+
+BOOST_AUTO_TEST_CASE( parallel_compaction_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 8);
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(2), std::size_t(1000), std::size_t(100001) }){
+        std::vector<int> values(n);
+        for(auto & v : values){
+            v = dist(rng);
+        }
+
+        check_compaction(parallel::seq, values);
+        check_compaction(parallel::par, values);
+        check_compaction(parallel::par.with(parallel::grain(100)), values);
+        check_compaction(parallel::par.with(parallel::grain(97), parallel::chunks(5)), values);
+        check_compaction(parallel::par_vec.with(parallel::dynamic, parallel::grain(1)), values);
+
+        thread_pool_executor pool(3);
+        check_compaction(parallel::par.on(pool).with(parallel::grain(333)), values);
+    }
+
+    // move only types
+    std::vector<std::unique_ptr<int> > ptrs;
+    for(int i = 0; i < 10000; ++i){
+        ptrs.emplace_back(new int(i / 3));
+    }
+
+    auto new_end = parallel::unique(parallel::par.with(parallel::grain(64)), ptrs.begin(), ptrs.end(),
+                                    [](const std::unique_ptr<int> & p1, const std::unique_ptr<int> & p2){
+        return *p1 == *p2;
+    });
+    ptrs.erase(new_end, ptrs.end());
+
+    BOOST_CHECK_EQUAL(ptrs.size(), 3334);
+    for(std::size_t i = 0; i < ptrs.size(); ++i){
+        BOOST_CHECK_EQUAL(*ptrs[i], int(i));
+    }
+
+    // types without default constructor
+    auto is_odd = [](const no_default_int & v){
+        return (v.value % 2) != 0;
+    };
+    auto same = [](const no_default_int & v1, const no_default_int & v2){
+        return v1.value == v2.value;
+    };
+
+    for(const auto & policy : { parallel::par.with(parallel::grain(64)), parallel::par.with(parallel::grain(1000000)) }){
+        std::vector<no_default_int> values;
+        for(int i = 0; i < 10000; ++i){
+            values.emplace_back(i / 3);
+        }
+
+        std::vector<no_default_int> removed(values);
+        removed.erase(parallel::remove_if(policy, removed.begin(), removed.end(), is_odd), removed.end());
+        BOOST_CHECK_EQUAL(removed.size(), 5001);
+        BOOST_CHECK(std::none_of(removed.begin(), removed.end(), is_odd));
+
+        std::vector<no_default_int> partitioned(values);
+        auto middle = parallel::partition(policy, partitioned.begin(), partitioned.end(), is_odd);
+        BOOST_CHECK_EQUAL(std::distance(partitioned.begin(), middle), 4999);
+        BOOST_CHECK(std::is_partitioned(partitioned.begin(), partitioned.end(), is_odd));
+
+        std::vector<no_default_int> uniques(values);
+        uniques.erase(parallel::unique(policy, uniques.begin(), uniques.end(), same), uniques.end());
+        BOOST_CHECK_EQUAL(uniques.size(), 3334);
+    }
+
+    std::vector<no_default_int> seq_values(10, no_default_int(3));
+    seq_values.erase(parallel::remove_if(parallel::seq, seq_values.begin(), seq_values.end(), is_odd), seq_values.end());
+    BOOST_CHECK(seq_values.empty());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_minmax_element_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-50, 50);
+
+    std::vector<int> values(200003);
+    for(auto & v : values){
+        v = dist(rng);
+    }
+
+    auto check_policy = [&](const parallel::parallel_execution_policy & policy){
+        // many equivalent minimums and maximums: the positions must match the std ones
+        BOOST_CHECK(parallel::min_element(policy, values.begin(), values.end()) == std::min_element(values.begin(), values.end()));
+        BOOST_CHECK(parallel::max_element(policy, values.begin(), values.end()) == std::max_element(values.begin(), values.end()));
+        BOOST_CHECK(parallel::minmax_element(policy, values.begin(), values.end()) == std::minmax_element(values.begin(), values.end()));
+
+        auto greater = std::greater<int>();
+        BOOST_CHECK(parallel::min_element(policy, values.begin(), values.end(), greater) == std::min_element(values.begin(), values.end(), greater));
+        BOOST_CHECK(parallel::minmax_element(policy, values.begin(), values.end(), greater) == std::minmax_element(values.begin(), values.end(), greater));
+
+        BOOST_CHECK(parallel::min_element(policy, values.begin(), values.begin()) == values.begin());
+        BOOST_CHECK(parallel::minmax_element(policy, values.end(), values.end()) == std::make_pair(values.end(), values.end()));
+    };
+
+    check_policy(parallel::par);
+    check_policy(parallel::par.with(parallel::chunks(17)));
+    check_policy(parallel::par.with(parallel::dynamic, parallel::grain(1000)));
+
+    BOOST_CHECK(parallel::max_element(parallel::seq, values.begin(), values.end()) == std::max_element(values.begin(), values.end()));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_nth_element_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(0, 1000);
+
+    std::vector<int> values(300001);
+    for(auto & v : values){
+        v = dist(rng);
+    }
+
+    std::vector<int> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    for(std::size_t nth : { std::size_t(0), std::size_t(1), std::size_t(150000), std::size_t(299999), std::size_t(300000) }){
+        std::vector<int> res(values);
+        parallel::nth_element(parallel::par.with(parallel::chunks(8)), res.begin(), res.begin() + nth, res.end());
+
+        BOOST_CHECK_EQUAL(res[nth], sorted[nth]);
+        BOOST_CHECK(std::all_of(res.begin(), res.begin() + nth, [&](int v){ return v <= res[nth]; }));
+        BOOST_CHECK(std::all_of(res.begin() + nth, res.end(), [&](int v){ return v >= res[nth]; }));
+    }
+
+    // all equivalent elements
+    std::vector<int> constant(100000, 3);
+    parallel::nth_element(parallel::par, constant.begin(), constant.begin() + 500, constant.end(), std::greater<int>());
+    BOOST_CHECK_EQUAL(std::count(constant.begin(), constant.end(), 3), 100000);
+
+    // partial sort
+    std::vector<int> partial(values);
+    const std::size_t k = 20000;
+    parallel::partial_sort(parallel::par.with(parallel::chunks(8)), partial.begin(), partial.begin() + k, partial.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(partial.begin(), partial.begin() + k, sorted.begin(), sorted.begin() + k);
+
+    std::vector<int> partial_seq(values);
+    parallel::partial_sort(parallel::seq, partial_seq.begin(), partial_seq.begin() + k, partial_seq.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(partial_seq.begin(), partial_seq.begin() + k, sorted.begin(), sorted.begin() + k);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_transform_mixed_types_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100000;
+
+    std::vector<int> v1(n);
+    std::vector<double> v2(n);
+    for(std::size_t i = 0; i < n; ++i){
+        v1[i] = int(i);
+        v2[i] = double(i) * 0.5;
+    }
+
+    auto ops = [](int a, double b){
+        return float(a) + float(b);
+    };
+
+    std::vector<float> expected(n), res(n), res_vec(n);
+    std::transform(v1.begin(), v1.end(), v2.data(), expected.begin(), ops);
+
+    // vector<int>::iterator, const double* and vector<float>::iterator
+    const double* v2_ptr = v2.data();
+    auto res_end = parallel::transform(parallel::par.with(parallel::chunks(7)), v1.begin(), v1.end(), v2_ptr, res.begin(), ops);
+    BOOST_CHECK(res_end == res.end());
+    BOOST_CHECK(res == expected);
+
+    parallel::transform(parallel::par_vec.with(parallel::chunks(7)), v1.cbegin(), v1.cend(), v2_ptr, res_vec.data(), ops);
+    BOOST_CHECK(res_vec == expected);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_transform_n_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 100000;
+
+    std::vector<int> values(n), res(n);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto plus_one = [](int v){ return v + 1; };
+    auto twice = [](int v){ return v * 2; };
+    auto to_double = [](int v){ return double(v) / 4; };
+
+    // out of place, three stages with a type change
+    std::vector<double> res_double(n);
+    auto res_end = parallel::transform_n(parallel::par.with(parallel::chunks(9)), values.begin(), values.end(), res_double.begin(),
+                                         plus_one, twice, to_double);
+    BOOST_CHECK(res_end == res_double.end());
+    for(std::size_t i = 0; i < n; ++i){
+        BOOST_CHECK_EQUAL(res_double[i], double((int(i) + 1) * 2) / 4);
+    }
+
+    // in place, order of the stages matters
+    parallel::transform_n(parallel::par_vec, values.begin(), values.end(), values.begin(), twice, plus_one);
+    for(std::size_t i = 0; i < n; ++i){
+        BOOST_CHECK_EQUAL(values[i], int(i) * 2 + 1);
+    }
+
+    // single stage, sequential
+    parallel::transform_n(parallel::seq, values.begin(), values.end(), res.begin(), plus_one);
+    BOOST_CHECK_EQUAL(res.back(), int(n - 1) * 2 + 2);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_for_loop_test)
+{
+    using namespace hadoken;
+
+    const int n = 100000;
+
+    std::vector<int> values(n), idx(n), gathered(n, -1);
+    std::iota(values.begin(), values.end(), 0);
+    for(int i = 0; i < n; ++i){
+        idx[i] = (i * 7) % n;
+    }
+
+    // gather with index
+    parallel::for_loop(parallel::par.with(parallel::chunks(9)), 0, n, [&](int i){
+        gathered[i] = values[idx[i]];
+    });
+    BOOST_CHECK(std::equal(gathered.begin(), gathered.end(), idx.begin()));
+
+    // reductions
+    long long sum = 0, product = 1;
+    int min_val = n, max_val = -1;
+    parallel::for_loop(parallel::par.with(parallel::dynamic, parallel::grain(1000)), 0, n,
+                       parallel::reduction_plus(sum), parallel::reduction_min(min_val), parallel::reduction_max(max_val),
+                       parallel::reduction(product, 1LL, [](long long a, long long b){ return (a * b) % 1000003; }),
+                       [&](int i, long long & local_sum, int & local_min, int & local_max, long long & local_product){
+        local_sum += values[i];
+        local_min = std::min(local_min, values[i]);
+        local_max = std::max(local_max, values[i]);
+        local_product = (local_product * (values[i] % 10 + 1)) % 1000003;
+    });
+
+    long long expected_product = 1;
+    for(int i = 0; i < n; ++i){
+        expected_product = (expected_product * (i % 10 + 1)) % 1000003;
+    }
+    BOOST_CHECK_EQUAL(sum, (long long)(n) * (n - 1) / 2);
+    BOOST_CHECK_EQUAL(min_val, 0);
+    BOOST_CHECK_EQUAL(max_val, n - 1);
+    BOOST_CHECK_EQUAL(product, expected_product);
+
+    // strided loop with inductions
+    std::size_t pos = 10, n_iter = 0;
+    std::vector<std::size_t> strided(n, 0);
+    parallel::for_loop_strided(parallel::par.with(parallel::chunks(5)), 3, n, 4,
+                               parallel::induction(pos, 2), parallel::reduction_plus(n_iter),
+                               [&](int i, std::size_t p, std::size_t & local_iter){
+        strided[i] = p;
+        local_iter += 1;
+    });
+    const std::size_t expected_iter = (n - 3 + 3) / 4;
+    BOOST_CHECK_EQUAL(n_iter, expected_iter);
+    BOOST_CHECK_EQUAL(pos, 10 + 2 * expected_iter);
+    for(int i = 3, k = 0; i < n; i += 4, ++k){
+        BOOST_CHECK_EQUAL(strided[i], std::size_t(10 + 2 * k));
+    }
+    BOOST_CHECK_EQUAL(strided[4], 0);
+
+    // negative stride on iterators
+    std::vector<int> reversed;
+    parallel::for_loop_strided(parallel::seq, values.end() - 1, values.begin() + (n / 2 - 1), -1,
+                               parallel::induction(0), [&](std::vector<int>::iterator it, int k){
+        BOOST_CHECK_EQUAL(*it, n - 1 - k);
+        reversed.push_back(*it);
+    });
+    BOOST_CHECK_EQUAL(reversed.size(), std::size_t(n - n / 2));
+
+    // for_loop_n and for_each_n
+    std::atomic<int> counter(0);
+    parallel::for_loop_n(parallel::par, 100, 50, [&](int i){
+        counter += i;
+    });
+    BOOST_CHECK_EQUAL(counter.load(), (100 + 149) * 50 / 2);
+
+    std::vector<int> ones(1000, 0);
+    auto it_end = parallel::for_each_n(parallel::par, ones.begin(), 600, [](int & v){ v = 1; });
+    BOOST_CHECK(it_end == ones.begin() + 600);
+    BOOST_CHECK_EQUAL(std::count(ones.begin(), ones.end(), 1), 600);
+
+    // list iterators, the index is stepped inside each chunk
+    std::list<int> lvalues(1001);
+    std::iota(lvalues.begin(), lvalues.end(), 0);
+
+    for(const auto & policy : { parallel::par.with(parallel::chunks(7)), parallel::par.with(parallel::grain(1000000)) }){
+        std::vector<int> visited(lvalues.size(), 0);
+        parallel::for_loop(policy, lvalues.begin(), lvalues.end(), parallel::induction(0), [&](std::list<int>::iterator it, int k){
+            BOOST_CHECK_EQUAL(*it, k);
+            visited[*it] += 1;
+        });
+        BOOST_CHECK_EQUAL(std::count(visited.begin(), visited.end(), 1), 1001);
+
+        std::fill(visited.begin(), visited.end(), 0);
+        parallel::for_loop_strided(policy, lvalues.begin(), lvalues.end(), 3, parallel::induction(0, 3),
+                                   [&](std::list<int>::iterator it, int k){
+            BOOST_CHECK_EQUAL(*it, k);
+            visited[*it] += 1;
+        });
+        BOOST_CHECK_EQUAL(std::count(visited.begin(), visited.end(), 1), 334);
+        BOOST_CHECK_EQUAL(visited[999], 1);
+
+        std::fill(visited.begin(), visited.end(), 0);
+        parallel::for_loop_strided(policy, std::prev(lvalues.end()), lvalues.begin(), -2,
+                                   parallel::induction(1000, -2), [&](std::list<int>::iterator it, int k){
+            BOOST_CHECK_EQUAL(*it, k);
+            visited[*it] += 1;
+        });
+        BOOST_CHECK_EQUAL(std::count(visited.begin(), visited.end(), 1), 500);
+        BOOST_CHECK_EQUAL(visited[0], 0);
+
+        std::atomic<int> list_sum(0);
+        parallel::for_loop_n(policy, std::next(lvalues.begin(), 100), 50, [&](std::list<int>::iterator it){
+            list_sum += *it;
+        });
+        BOOST_CHECK_EQUAL(list_sum.load(), (100 + 149) * 50 / 2);
+    }
+
+    // empty loop
+    int untouched = 5;
+    parallel::for_loop(parallel::par, 10, 10, parallel::reduction_plus(untouched), [](int, int & v){ v += 1; });
+    BOOST_CHECK_EQUAL(untouched, 5);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_deterministic_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n = 1000003;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+    std::vector<double> values(n);
+    for(auto & v : values){
+        v = dist(rng) * std::pow(10.0, double(rng() % 12) - 6);
+    }
+
+    // the chunk boundaries do not depend on the executors
+    const std::size_t n_blocks = (n + parallel::detail::default_block_size - 1) / parallel::detail::default_block_size;
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par_deterministic, n), n_blocks);
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par_deterministic.with(parallel::grain(1000)), n), 1001);
+    BOOST_CHECK_EQUAL(count_chunks_and_check(parallel::par.with(parallel::deterministic, parallel::chunks(7)), n), 7);
+
+    const double ref_sum = parallel::reduce(parallel::par_deterministic, values.begin(), values.end(), 0.0);
+
+    std::vector<double> ref_scan(n);
+    parallel::inclusive_scan(parallel::par_deterministic, values.begin(), values.end(), ref_scan.begin());
+
+    for(std::size_t n_threads : { 1, 2, 3, 5, 8 }){
+        thread_pool_executor pool(n_threads);
+
+        const double sum = parallel::reduce(parallel::par_deterministic.on(pool), values.begin(), values.end(), 0.0);
+        BOOST_CHECK_EQUAL(std::memcmp(&sum, &ref_sum, sizeof(double)), 0);
+
+        std::vector<double> scan(n);
+        parallel::inclusive_scan(parallel::par_deterministic.on(pool), values.begin(), values.end(), scan.begin());
+        BOOST_CHECK(std::memcmp(scan.data(), ref_scan.data(), n * sizeof(double)) == 0);
+
+        double loop_sum = 0;
+        parallel::for_loop(parallel::par_deterministic.on(pool), std::size_t(0), n, parallel::reduction_plus(loop_sum),
+                           [&](std::size_t i, double & local_sum){
+            local_sum += values[i];
+        });
+
+        double ref_loop_sum = 0;
+        parallel::for_loop(parallel::par_deterministic, std::size_t(0), n, parallel::reduction_plus(ref_loop_sum),
+                           [&](std::size_t i, double & local_sum){
+            local_sum += values[i];
+        });
+        BOOST_CHECK_EQUAL(std::memcmp(&loop_sum, &ref_loop_sum, sizeof(double)), 0);
+    }
+}
+
+
+
+template<typename Engine, typename Distribution>
+void check_generate_random(const Engine & engine, const Distribution & dist, std::size_t n){
+    using namespace hadoken;
+    using value_type = typename Distribution::result_type;
+
+    Engine ref_engine(engine);
+    std::vector<value_type> ref(n);
+    parallel::generate_random(parallel::seq, ref.begin(), ref.end(), ref_engine, dist);
+
+    // first block is generated by the stream derivated with the id 0
+    {
+        Engine block_engine = random_engine_derivate(engine, typename Engine::result_type(0));
+        Distribution block_dist(dist);
+        const std::size_t first_block = std::min(n, parallel::detail::random_block_size);
+        for(std::size_t i = 0; i < first_block; ++i){
+            const value_type v = block_dist(block_engine);
+            BOOST_CHECK(std::memcmp(&v, &ref[i], sizeof(value_type)) == 0);
+        }
+    }
+
+    auto check_policy = [&](const std::string & name, std::function<void (Engine &, std::vector<value_type> &)> gen){
+        Engine eng(engine);
+        std::vector<value_type> values(n);
+        gen(eng, values);
+        BOOST_CHECK_MESSAGE(std::memcmp(values.data(), ref.data(), n * sizeof(value_type)) == 0, "generate_random " << name);
+        BOOST_CHECK(eng == ref_engine);
+    };
+
+    check_policy("par", [&](Engine & eng, std::vector<value_type> & values){
+        parallel::generate_random(parallel::par, values.begin(), values.end(), eng, dist);
+    });
+
+    check_policy("par chunks", [&](Engine & eng, std::vector<value_type> & values){
+        parallel::generate_random(parallel::par.with(parallel::chunks(7)), values.begin(), values.end(), eng, dist);
+    });
+
+    for(std::size_t n_threads : { 1, 2, 3 }){
+        thread_pool_executor pool(n_threads);
+        check_policy("pool", [&](Engine & eng, std::vector<value_type> & values){
+            parallel::generate_random(parallel::par.on(pool), values.begin(), values.end(), eng, dist);
+        });
+    }
+
+    // the engine has been advanced: next call generates a new sequence
+    if(n > 0){
+        std::vector<value_type> next(n);
+        parallel::generate_random(parallel::par, next.begin(), next.end(), ref_engine, dist);
+        BOOST_CHECK(next != ref);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_generate_random_test)
+{
+    using namespace hadoken;
+
+    const std::size_t block = parallel::detail::random_block_size;
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), block - 1, block, 10 * block + 17 }){
+        check_generate_random(counter_engine<threefry4x64>(42), std::uniform_real_distribution<double>(0, 1), n);
+        check_generate_random(counter_engine<threefry2x32>(7), std::normal_distribution<float>(5.0f, 2.0f), n);
+        check_generate_random(std::mt19937(11), std::uniform_int_distribution<int>(-100, 100), n);
+        // bulk distributions
+        static_assert(parallel::detail::has_bulk_generate<hadoken::uniform01<double>, counter_engine<threefry4x64>,
+                                                          std::vector<double>::iterator>::value, "bulk uniform01");
+        static_assert(!parallel::detail::has_bulk_generate<std::uniform_real_distribution<double>, counter_engine<threefry4x64>,
+                                                           std::vector<double>::iterator>::value, "scalar std distribution");
+        check_generate_random(counter_engine<threefry4x64>(42), hadoken::uniform01<double>(), n);
+        check_generate_random(counter_engine<philox4x32>(3), hadoken::normal_distribution<float>(5.0f, 2.0f), n);
+        check_generate_random(counter_engine<threefry2x64>(9), hadoken::exponential_distribution<double>(0.5), n);
+    }
+}
+
+
+
+template<typename Policy>
+void check_set_operations(Policy && policy, const std::vector<int> & a, const std::vector<int> & b){
+    using namespace hadoken;
+
+    std::vector<int> ref, res(a.size() + b.size());
+
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref));
+    auto res_end = parallel::set_intersection(policy, a.begin(), a.end(), b.begin(), b.end(), res.begin());
+    BOOST_CHECK(std::vector<int>(res.begin(), res_end) == ref);
+
+    ref.clear();
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref));
+    res_end = parallel::set_union(policy, a.begin(), a.end(), b.begin(), b.end(), res.begin());
+    BOOST_CHECK(std::vector<int>(res.begin(), res_end) == ref);
+
+    ref.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref));
+    res_end = parallel::set_difference(policy, a.begin(), a.end(), b.begin(), b.end(), res.begin());
+    BOOST_CHECK(std::vector<int>(res.begin(), res_end) == ref);
+
+    // output iterators fall back to the sequential algorithm
+    std::vector<int> res_back;
+    parallel::set_difference(policy, a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res_back));
+    BOOST_CHECK(res_back == ref);
+
+    ref.clear();
+    res_back.clear();
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref));
+    parallel::set_intersection(policy, a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res_back));
+    BOOST_CHECK(res_back == ref);
+
+    ref.clear();
+    res_back.clear();
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref));
+    parallel::set_union(policy, a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res_back));
+    BOOST_CHECK(res_back == ref);
+
+    std::vector<std::vector<int>::const_iterator> bounds(b.size()), ref_bounds;
+    for(int q : b){
+        ref_bounds.push_back(std::lower_bound(a.begin(), a.end(), q));
+    }
+    auto bounds_end = parallel::lower_bound_n(policy, a.begin(), a.end(), b.begin(), b.size(), bounds.begin());
+    BOOST_CHECK(bounds_end == bounds.end());
+    BOOST_CHECK(bounds == ref_bounds);
+
+    std::vector<std::vector<int>::const_iterator> bounds_back;
+    parallel::lower_bound_n(policy, a.begin(), a.end(), b.begin(), b.size(), std::back_inserter(bounds_back));
+    BOOST_CHECK(bounds_back == ref_bounds);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_set_operations_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(5);
+
+    for(std::size_t n : { 0, 1, 100, 50000 }){
+        // small value domains create long runs of duplicates across the blocks
+        for(int domain : { 4, 1000, 1000000 }){
+            std::uniform_int_distribution<int> dist(0, domain);
+            std::vector<int> a(n), b(n / 2 + 3);
+            std::generate(a.begin(), a.end(), [&]{ return dist(rng); });
+            std::generate(b.begin(), b.end(), [&]{ return dist(rng) + domain / 3; });
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+
+            check_set_operations(parallel::seq, a, b);
+            check_set_operations(parallel::par, a, b);
+            check_set_operations(parallel::par.with(parallel::grain(97)), a, b);
+            check_set_operations(parallel::par.with(parallel::grain(1)), b, a);
+            check_set_operations(parallel::par.with(parallel::chunks(7)), a, b);
+
+            thread_pool_executor pool(3);
+            check_set_operations(parallel::par.on(pool).with(parallel::grain(333)), a, b);
+        }
+    }
+
+    // comparator and non random access ranges
+    {
+        std::vector<int> a = { 9, 9, 7, 5, 5, 5, 3, 1 }, b = { 9, 8, 5, 5, 1, 1 };
+        std::list<int> la(a.begin(), a.end()), lb(b.begin(), b.end());
+        std::vector<int> ref, res(a.size() + b.size());
+
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ref), std::greater<int>());
+        auto res_end = parallel::set_union(parallel::par.with(parallel::grain(2)), a.begin(), a.end(), b.begin(), b.end(),
+                                           res.begin(), std::greater<int>());
+        BOOST_CHECK(std::vector<int>(res.begin(), res_end) == ref);
+
+        res_end = parallel::set_union(parallel::par, la.begin(), la.end(), lb.begin(), lb.end(), res.begin(), std::greater<int>());
+        BOOST_CHECK(std::vector<int>(res.begin(), res_end) == ref);
+
+        std::vector<std::list<int>::iterator> bounds(lb.size());
+        parallel::lower_bound_n(parallel::par, la.begin(), la.end(), lb.begin(), lb.size(), bounds.begin(), std::greater<int>());
+        auto q = lb.begin();
+        for(auto it : bounds){
+            BOOST_CHECK(it == std::lower_bound(la.begin(), la.end(), *q, std::greater<int>()));
+            ++q;
+        }
+    }
+}
+
+
+
+template<typename Policy>
+void check_histogram(Policy && policy, const std::vector<std::size_t> & values, std::size_t n_bins){
+    using namespace hadoken;
+
+    std::vector<std::size_t> ref(n_bins, 1), bins(n_bins, 1);
+    std::vector<double> ref_weighted(n_bins, 0), weighted(n_bins, 0);
+    for(std::size_t v : values){
+        ref[v % n_bins] += 1;
+        ref_weighted[v % n_bins] += 0.5;
+    }
+
+    auto keyfn = [n_bins](std::size_t v){ return v % n_bins; };
+    parallel::histogram(policy, values.begin(), values.end(), bins.begin(), bins.end(), keyfn);
+    BOOST_CHECK(bins == ref);
+
+    parallel::histogram(policy, values.begin(), values.end(), weighted.begin(), weighted.end(), keyfn,
+                        [](std::size_t){ return 0.5; });
+    BOOST_CHECK(weighted == ref_weighted);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_histogram_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(9);
+    std::vector<std::size_t> values(200000);
+    std::generate(values.begin(), values.end(), [&]{ return std::size_t(rng()); });
+
+    for(std::size_t n_bins : { std::size_t(1), std::size_t(17), std::size_t(1000),
+                               parallel::detail::histogram_private_bins_limit + 1, std::size_t(1) << 20 }){
+        check_histogram(parallel::seq, values, n_bins);
+        check_histogram(parallel::par, values, n_bins);
+        check_histogram(parallel::par.with(parallel::grain(1000)), values, n_bins);
+
+        thread_pool_executor pool(3);
+        check_histogram(parallel::par.on(pool).with(parallel::chunks(11)), values, n_bins);
+    }
+
+    // empty range does not touch the bins
+    std::vector<std::size_t> bins(4, 2);
+    parallel::histogram(parallel::par, values.begin(), values.begin(), bins.begin(), bins.end(), [](std::size_t){ return 0; });
+    BOOST_CHECK(bins == std::vector<std::size_t>(4, 2));
+}
+
+
+
+template<typename Policy>
+void check_reduce_by_key(Policy && policy, const std::vector<int> & keys, const std::vector<long> & values){
+    using namespace hadoken;
+
+    std::vector<int> ref_keys;
+    std::vector<long> ref_values;
+    for(std::size_t i = 0; i < keys.size(); ++i){
+        if(i == 0 || keys[i] != keys[i - 1]){
+            ref_keys.push_back(keys[i]);
+            ref_values.push_back(0);
+        }
+        ref_values.back() += values[i];
+    }
+
+    std::vector<int> res_keys(keys.size());
+    std::vector<long> res_values(keys.size());
+    auto res_end = parallel::reduce_by_key(policy, keys.begin(), keys.end(), values.begin(), res_keys.begin(), res_values.begin());
+
+    BOOST_CHECK(std::vector<int>(res_keys.begin(), res_end.first) == ref_keys);
+    BOOST_CHECK(std::vector<long>(res_values.begin(), res_end.second) == ref_values);
+
+    // output iterators fall back to the sequential algorithm
+    std::vector<int> res_keys_back;
+    std::vector<long> res_values_back;
+    parallel::reduce_by_key(policy, keys.begin(), keys.end(), values.begin(),
+                            std::back_inserter(res_keys_back), std::back_inserter(res_values_back));
+    BOOST_CHECK(res_keys_back == ref_keys);
+    BOOST_CHECK(res_values_back == ref_values);
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_reduce_by_key_test)
+{
+    using namespace hadoken;
+
+    std::mt19937 rng(13);
+
+    for(std::size_t n : { 0, 1, 1000, 100000 }){
+        // short runs, and runs longer than the blocks
+        for(std::size_t run_length : { 1, 5, 20000 }){
+            std::vector<int> keys(n);
+            std::vector<long> values(n);
+            for(std::size_t i = 0; i < n; ++i){
+                keys[i] = int((i / run_length) % 3) + (rng() % run_length == 0 ? 1 : 0);
+                values[i] = long(rng() % 100);
+            }
+
+            check_reduce_by_key(parallel::seq, keys, values);
+            check_reduce_by_key(parallel::par, keys, values);
+            check_reduce_by_key(parallel::par.with(parallel::grain(7)), keys, values);
+
+            thread_pool_executor pool(3);
+            check_reduce_by_key(parallel::par.on(pool).with(parallel::grain(999)), keys, values);
+        }
+    }
+
+    // custom predicate and operation
+    std::vector<int> keys = { 1, 2, 4, 5, 7, 10 }, res_keys(keys.size());
+    std::vector<int> values = { 1, 2, 3, 4, 5, 6 }, res_values(keys.size());
+    auto res_end = parallel::reduce_by_key(parallel::par.with(parallel::grain(2)), keys.begin(), keys.end(), values.begin(),
+                                           res_keys.begin(), res_values.begin(),
+                                           [](int a, int b){ return b - a == 1; }, [](int a, int b){ return std::max(a, b); });
+    BOOST_CHECK(std::vector<int>(res_keys.begin(), res_end.first) == std::vector<int>({ 1, 4, 7, 10 }));
+    BOOST_CHECK(std::vector<int>(res_values.begin(), res_end.second) == std::vector<int>({ 2, 4, 5, 6 }));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( parallel_for_range_aligned_test)
+{
+    using namespace hadoken;
+
+    std::vector<float> values(100003);
+
+    for(auto policy : { parallel::par.with(parallel::chunks(7)), parallel::par.with(parallel::dynamic, parallel::grain(1000)) }){
+        std::mutex lock;
+        std::vector<std::pair<std::size_t, std::size_t> > chunks;
+
+        parallel::for_range(policy, values.begin(), values.end(), [&](std::vector<float>::iterator first, std::vector<float>::iterator last){
+            std::lock_guard<std::mutex> l(lock);
+            chunks.emplace_back(first - values.begin(), last - values.begin());
+        });
+
+        std::sort(chunks.begin(), chunks.end());
+        BOOST_CHECK_EQUAL(chunks.front().first, 0);
+        BOOST_CHECK_EQUAL(chunks.back().second, values.size());
+        for(std::size_t i = 1; i < chunks.size(); ++i){
+            BOOST_CHECK_EQUAL(chunks[i - 1].second, chunks[i].first);
+            BOOST_CHECK(chunks[i].first < chunks[i].second);
+            BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(values.data() + chunks[i].first) % cache_line_size, 0);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( parallel_for_range_2d_test)
+{
+    using namespace hadoken;
+
+    const std::size_t n_rows = 301, n_cols = 517;
+    std::vector<int> mat(n_rows * n_cols), transposed(n_rows * n_cols, -1);
+    std::iota(mat.begin(), mat.end(), 0);
+
+    thread_pool_executor pool(3);
+
+    const blocked_range2d<std::size_t> r(0, n_rows, 0, n_cols, 32, 32);
+    parallel::for_range(parallel::par.on(pool), r, [&](const blocked_range2d<std::size_t> & tile){
+        for(std::size_t i = tile.rows_begin(); i < tile.rows_end(); ++i){
+            for(std::size_t j = tile.cols_begin(); j < tile.cols_end(); ++j){
+                transposed[j * n_rows + i] = mat[i * n_cols + j];
+            }
+        }
+    });
+
+    bool valid = true;
+    for(std::size_t i = 0; i < n_rows; ++i){
+        for(std::size_t j = 0; j < n_cols; ++j){
+            valid = valid && (transposed[j * n_rows + i] == mat[i * n_cols + j]);
+        }
+    }
+    BOOST_CHECK(valid);
+}
@@ -36,6 +36,10 @@
 
 #include <boost/random.hpp>
 
+#include <iterator>
+#include <list>
+#include <vector>
+
 #include <hadoken/random/random.hpp>
 
 
@@ -329,6 +333,16 @@ typedef boost::mpl::list<hadoken::threefry2x32,
                         hadoken::threefry2x64,
                         hadoken::threefry4x64> threefry_types;
 
+typedef boost::mpl::list<hadoken::threefry2x32,
+                        hadoken::threefry4x32,
+                        hadoken::threefry2x64,
+                        hadoken::threefry4x64,
+                        hadoken::philox2x32,
+                        hadoken::philox4x32,
+                        hadoken::philox2x64,
+                        hadoken::philox4x64,
+                        hadoken::ars4x32> counter_engine_types;
+
 BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_distribute, T, threefry_types )
 {
         boost::random::uniform_int_distribution<boost::uint64_t> dist100(0, 100);
@@ -351,7 +365,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_distribute, T, threefry_types )
 
 
 
-BOOST_AUTO_TEST_CASE_TEMPLATE( engine_discard, T, threefry_types )
+BOOST_AUTO_TEST_CASE_TEMPLATE( engine_discard, T, counter_engine_types )
 {
 
     // basic consistency test
@@ -461,3 +475,626 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( engine_discard, T, threefry_types )
 
 }
 
+
+
+
+BOOST_AUTO_TEST_CASE( threefry_known_answers)
+{
+    // known answer tests of the Random123 distribution, 20 rounds, zero counter and key
+    {
+        hadoken::threefry4x64 b;
+        const hadoken::threefry4x64::range_type res = b(hadoken::threefry4x64::domain_type());
+        BOOST_CHECK_EQUAL(res[0], UINT64_C(0x09218ebde6c85537));
+        BOOST_CHECK_EQUAL(res[1], UINT64_C(0x55941f5266d86105));
+        BOOST_CHECK_EQUAL(res[2], UINT64_C(0x4bd25e16282434dc));
+        BOOST_CHECK_EQUAL(res[3], UINT64_C(0xee29ec846bd2e40b));
+    }
+    {
+        hadoken::threefry2x64 b;
+        const hadoken::threefry2x64::range_type res = b(hadoken::threefry2x64::domain_type());
+        BOOST_CHECK_EQUAL(res[0], UINT64_C(0xc2b6e3a8c2c69865));
+        BOOST_CHECK_EQUAL(res[1], UINT64_C(0x6f81ed42f350084d));
+    }
+    {
+        hadoken::threefry2x32 b;
+        const hadoken::threefry2x32::range_type res = b(hadoken::threefry2x32::domain_type());
+        BOOST_CHECK_EQUAL(res[0], UINT32_C(0x6b200159));
+        BOOST_CHECK_EQUAL(res[1], UINT32_C(0x99ba4efe));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_const_keyed, T, threefry_types )
+{
+    typedef typename T::uint_type uint_type;
+
+    typename T::key_type key, other_key;
+    for(std::size_t i = 0; i < key.size(); ++i){
+        key[i] = static_cast<uint_type>(0x9e3779b97f4a7c15ULL * (i + 1));
+        other_key[i] = static_cast<uint_type>(i);
+    }
+
+    typename T::domain_type counter;
+    counter.fill(uint_type(12345));
+
+    // the key schedule follows the key changes
+    T b_rekeyed(other_key);
+    b_rekeyed.set_key(key);
+    BOOST_CHECK(b_rekeyed.get_key() == key);
+
+    const T b(key);
+    BOOST_CHECK(b == b_rekeyed);
+    BOOST_CHECK(b(counter) == b_rekeyed(counter));
+    BOOST_CHECK(b(counter) != T(other_key)(counter));
+
+    // stateless keyed hashing through a const engine
+    const hadoken::counter_engine<T> engine(key);
+    BOOST_CHECK(engine(counter) == b(counter));
+    BOOST_CHECK(engine.getseed() == key);
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( threefry_multi_block, T, threefry_types )
+{
+    typedef typename T::domain_type domain_type;
+    typedef typename T::uint_type uint_type;
+
+    typename T::key_type key;
+    for(std::size_t i = 0; i < key.size(); ++i){
+        key[i] = static_cast<uint_type>(0x9e3779b97f4a7c15ULL * (i + 1));
+    }
+    T b(key);
+
+    const std::size_t lanes = hadoken::impl::threefry_lanes<uint_type>::value;
+
+    // first counter word close to overflow: the carry has to be propagated inside the groups
+    domain_type start;
+    start.fill(0);
+    start[0] = std::numeric_limits<uint_type>::max() - 2;
+    start[1] = 7;
+
+    for(std::size_t n : { std::size_t(0), std::size_t(1), lanes - 1, lanes, lanes + 1, std::size_t(3 * lanes + 2), std::size_t(100) }){
+        std::vector<typename T::range_type> bulk(n + 1);
+        bulk[n].fill(42);
+        b(start, bulk.data(), n);
+
+        domain_type ctr = start;
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK(bulk[i] == b(ctr));
+            hadoken::impl::counter_add(ctr, uint_type(1));
+        }
+
+        // nothing written after the n blocks
+        BOOST_CHECK_EQUAL(bulk[n][0], 42);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( engine_generate, T, counter_engine_types )
+{
+    typedef hadoken::counter_engine<T> engine_type;
+    typedef typename engine_type::result_type result_type;
+
+    engine_type engine_bulk(42), engine_ref(42);
+
+    // odd sizes to start and end in the middle of blocks, big ones to cross several batches
+    for(std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(3), std::size_t(8),
+                          std::size_t(1001), std::size_t(5000), std::size_t(7) }){
+        std::vector<result_type> values(n);
+        engine_bulk.generate(values.begin(), values.end());
+
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK_EQUAL(values[i], engine_ref());
+        }
+        BOOST_CHECK(engine_bulk == engine_ref);
+    }
+
+    // raw pointer fill
+    std::vector<result_type> raw(777);
+    engine_bulk.fill(raw.data(), raw.size());
+    for(std::size_t i = 0; i < raw.size(); ++i){
+        BOOST_CHECK_EQUAL(raw[i], engine_ref());
+    }
+
+    // non contiguous destination, engine state consistent after it
+    std::list<result_type> l(301);
+    engine_bulk.generate(l.begin(), l.end());
+    for(result_type v : l){
+        BOOST_CHECK_EQUAL(v, engine_ref());
+    }
+    BOOST_CHECK_EQUAL(engine_bulk(), engine_ref());
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE( philox_known_answers)
+{
+    // known answer tests of the Random123 distribution, 10 rounds
+    // zero counter and key, all bits set, and digits of pi
+    {
+        typedef hadoken::philox2x32 cbrng;
+        const cbrng::domain_type zero = {{ 0, 0 }}, ones = {{ 0xffffffff, 0xffffffff }}, pi = {{ 0x243f6a88, 0x85a308d3 }};
+        const cbrng::key_type zero_k = {{ 0 }}, ones_k = {{ 0xffffffff }}, pi_k = {{ 0x13198a2e }};
+
+        const cbrng::range_type res_zero = cbrng(zero_k)(zero), res_ones = cbrng(ones_k)(ones), res_pi = cbrng(pi_k)(pi);
+        BOOST_CHECK_EQUAL(res_zero[0], UINT32_C(0xff1dae59));
+        BOOST_CHECK_EQUAL(res_zero[1], UINT32_C(0x6cd10df2));
+        BOOST_CHECK_EQUAL(res_ones[0], UINT32_C(0x2c3f628b));
+        BOOST_CHECK_EQUAL(res_ones[1], UINT32_C(0xab4fd7ad));
+        BOOST_CHECK_EQUAL(res_pi[0], UINT32_C(0xdd7ce038));
+        BOOST_CHECK_EQUAL(res_pi[1], UINT32_C(0xf62a4c12));
+    }
+    {
+        typedef hadoken::philox4x32 cbrng;
+        const cbrng::domain_type zero = {{ 0, 0, 0, 0 }}, ones = {{ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }},
+                pi = {{ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }};
+        const cbrng::key_type zero_k = {{ 0, 0 }}, ones_k = {{ 0xffffffff, 0xffffffff }}, pi_k = {{ 0xa4093822, 0x299f31d0 }};
+
+        const cbrng::range_type res_zero = cbrng(zero_k)(zero), res_ones = cbrng(ones_k)(ones), res_pi = cbrng(pi_k)(pi);
+        BOOST_CHECK_EQUAL(res_zero[0], UINT32_C(0x6627e8d5));
+        BOOST_CHECK_EQUAL(res_zero[1], UINT32_C(0xe169c58d));
+        BOOST_CHECK_EQUAL(res_zero[2], UINT32_C(0xbc57ac4c));
+        BOOST_CHECK_EQUAL(res_zero[3], UINT32_C(0x9b00dbd8));
+        BOOST_CHECK_EQUAL(res_ones[0], UINT32_C(0x408f276d));
+        BOOST_CHECK_EQUAL(res_ones[1], UINT32_C(0x41c83b0e));
+        BOOST_CHECK_EQUAL(res_ones[2], UINT32_C(0xa20bc7c6));
+        BOOST_CHECK_EQUAL(res_ones[3], UINT32_C(0x6d5451fd));
+        BOOST_CHECK_EQUAL(res_pi[0], UINT32_C(0xd16cfe09));
+        BOOST_CHECK_EQUAL(res_pi[1], UINT32_C(0x94fdcceb));
+        BOOST_CHECK_EQUAL(res_pi[2], UINT32_C(0x5001e420));
+        BOOST_CHECK_EQUAL(res_pi[3], UINT32_C(0x24126ea1));
+    }
+    {
+        typedef hadoken::philox2x64 cbrng;
+        const cbrng::domain_type zero = {{ 0, 0 }}, ones = {{ UINT64_C(0xffffffffffffffff), UINT64_C(0xffffffffffffffff) }},
+                pi = {{ UINT64_C(0x243f6a8885a308d3), UINT64_C(0x13198a2e03707344) }};
+        const cbrng::key_type zero_k = {{ 0 }}, ones_k = {{ UINT64_C(0xffffffffffffffff) }}, pi_k = {{ UINT64_C(0xa4093822299f31d0) }};
+
+        const cbrng::range_type res_zero = cbrng(zero_k)(zero), res_ones = cbrng(ones_k)(ones), res_pi = cbrng(pi_k)(pi);
+        BOOST_CHECK_EQUAL(res_zero[0], UINT64_C(0xca00a0459843d731));
+        BOOST_CHECK_EQUAL(res_zero[1], UINT64_C(0x66c24222c9a845b5));
+        BOOST_CHECK_EQUAL(res_ones[0], UINT64_C(0x65b021d60cd8310f));
+        BOOST_CHECK_EQUAL(res_ones[1], UINT64_C(0x4d02f3222f86df20));
+        BOOST_CHECK_EQUAL(res_pi[0], UINT64_C(0x0a5e742c2997341c));
+        BOOST_CHECK_EQUAL(res_pi[1], UINT64_C(0xb0f883d38000de5d));
+    }
+    {
+        typedef hadoken::philox4x64 cbrng;
+        const cbrng::domain_type zero = {{ 0, 0, 0, 0 }};
+        const cbrng::key_type zero_k = {{ 0, 0 }};
+
+        const cbrng::range_type res_zero = cbrng(zero_k)(zero);
+        BOOST_CHECK_EQUAL(res_zero[0], UINT64_C(0x16554d9eca36314c));
+        BOOST_CHECK_EQUAL(res_zero[1], UINT64_C(0xdb20fe9d672d0fdc));
+        BOOST_CHECK_EQUAL(res_zero[2], UINT64_C(0xd7e772cee186176b));
+        BOOST_CHECK_EQUAL(res_zero[3], UINT64_C(0x7e68b68aec7ba23b));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( philox_derivate)
+{
+    typedef hadoken::counter_engine<hadoken::philox4x32> engine_type;
+
+    engine_type engine(1234);
+
+    // the key is half the size of a block, derivation still needs to be deterministic and distinct
+    engine_type derivated = engine.derivate(42), derivated_same = engine.derivate(42), derivated_differ = engine.derivate(43);
+
+    BOOST_CHECK(derivated == derivated_same);
+    BOOST_CHECK(derivated != derivated_differ);
+
+    for(std::size_t i = 0; i < 100; ++i){
+        const engine_type::result_type v1 = engine(), v2 = derivated(), v3 = derivated_same(), v4 = derivated_differ();
+        BOOST_CHECK_NE(v1, v2);
+        BOOST_CHECK_EQUAL(v2, v3);
+        BOOST_CHECK_NE(v2, v4);
+    }
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE( aes_round_fips197)
+{
+    // AES-128 example vector of FIPS-197 appendix C.1, from the portable AES rounds
+    // bytes are stored as little endian columns
+    const hadoken::impl::aes_block plain = {{ 0x33221100, 0x77665544, 0xbbaa9988, 0xffeeddcc }};
+    const hadoken::impl::aes_block key = {{ 0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c }};
+
+    const hadoken::impl::aes_tables & tables = hadoken::impl::get_aes_tables();
+
+    // AES-128 key expansion
+    boost::array<hadoken::impl::aes_block, 11> round_keys;
+    round_keys[0] = key;
+    boost::uint32_t rcon = 0x01;
+    for(std::size_t r = 1; r < round_keys.size(); ++r){
+        const boost::uint32_t prev = round_keys[r-1][3];
+        // RotWord then SubWord
+        const boost::uint32_t rot = (prev >> 8) | (prev << 24);
+        boost::uint32_t temp = boost::uint32_t(tables.sbox[rot & 0xFF])
+                | (boost::uint32_t(tables.sbox[(rot >> 8) & 0xFF]) << 8)
+                | (boost::uint32_t(tables.sbox[(rot >> 16) & 0xFF]) << 16)
+                | (boost::uint32_t(tables.sbox[rot >> 24]) << 24);
+        temp ^= rcon;
+        rcon = hadoken::impl::aes_tables::xtime(static_cast<boost::uint8_t>(rcon));
+
+        round_keys[r][0] = round_keys[r-1][0] ^ temp;
+        for(std::size_t i = 1; i < 4; ++i){
+            round_keys[r][i] = round_keys[r-1][i] ^ round_keys[r][i-1];
+        }
+    }
+
+    hadoken::impl::aes_block state;
+    for(std::size_t i = 0; i < 4; ++i){
+        state[i] = plain[i] ^ round_keys[0][i];
+    }
+    for(std::size_t r = 1; r < 10; ++r){
+        hadoken::impl::aes_enc_round(state, round_keys[r]);
+    }
+    hadoken::impl::aes_enc_last_round(state, round_keys[10]);
+
+    // 69c4e0d8 6a7b0430 d8cdb780 70b4c55a
+    BOOST_CHECK_EQUAL(state[0], UINT32_C(0xd8e0c469));
+    BOOST_CHECK_EQUAL(state[1], UINT32_C(0x30047b6a));
+    BOOST_CHECK_EQUAL(state[2], UINT32_C(0x80b7cdd8));
+    BOOST_CHECK_EQUAL(state[3], UINT32_C(0x5ac5b470));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( ars_known_answers)
+{
+    // ars4x32 with 7 rounds, reference values of the AES-NI implementation of Random123 ars1xm128i
+    // for zero counter and key, all bits set, and digits of pi
+    typedef hadoken::ars4x32 cbrng;
+
+    const cbrng::domain_type zero = {{ 0, 0, 0, 0 }}, ones = {{ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }},
+            pi = {{ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }};
+    const cbrng::key_type zero_k = {{ 0, 0, 0, 0 }}, ones_k = {{ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }},
+            pi_k = {{ 0xa4093822, 0x299f31d0, 0x082efa98, 0xec4e6c89 }};
+
+    const cbrng::range_type res_zero = cbrng(zero_k)(zero), res_ones = cbrng(ones_k)(ones), res_pi = cbrng(pi_k)(pi);
+    BOOST_CHECK_EQUAL(res_zero[0], UINT32_C(0xdacf61ff));
+    BOOST_CHECK_EQUAL(res_zero[1], UINT32_C(0xc45798f3));
+    BOOST_CHECK_EQUAL(res_zero[2], UINT32_C(0x113c7eeb));
+    BOOST_CHECK_EQUAL(res_zero[3], UINT32_C(0x101e27f3));
+    BOOST_CHECK_EQUAL(res_ones[0], UINT32_C(0xfbaaff1f));
+    BOOST_CHECK_EQUAL(res_ones[1], UINT32_C(0xbb547ef9));
+    BOOST_CHECK_EQUAL(res_ones[2], UINT32_C(0x13d8cd78));
+    BOOST_CHECK_EQUAL(res_ones[3], UINT32_C(0x7aaa969b));
+    BOOST_CHECK_EQUAL(res_pi[0], UINT32_C(0xd1df87af));
+    BOOST_CHECK_EQUAL(res_pi[1], UINT32_C(0xf67d43ba));
+    BOOST_CHECK_EQUAL(res_pi[2], UINT32_C(0x4f66afdb));
+    BOOST_CHECK_EQUAL(res_pi[3], UINT32_C(0x393dcb2d));
+
+    // bulk path across a carry of the first counter word
+    const cbrng b(pi_k);
+    cbrng::domain_type start = {{ 0xfffffffd, 0xffffffff, 7, 0 }};
+    std::vector<cbrng::range_type> bulk(11);
+    b(start, bulk.data(), bulk.size());
+    for(std::size_t i = 0; i < bulk.size(); ++i){
+        BOOST_CHECK(bulk[i] == b(start));
+        hadoken::impl::counter_add(start, boost::uint32_t(1));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( engine_value_at, T, counter_engine_types )
+{
+    typedef hadoken::counter_engine<T> engine_type;
+
+    engine_type engine(42);
+    const engine_type engine_origin(engine);
+
+    // same values than the sequential stream
+    for(boost::uintmax_t i = 0; i < 101; ++i){
+        BOOST_CHECK_EQUAL(engine_origin.value_at(i), engine());
+    }
+
+    // the engine state is not involved
+    BOOST_CHECK_EQUAL(engine.value_at(7), engine_origin.value_at(7));
+
+    // far positions, consistent with discard
+    for(boost::uintmax_t pos : { boost::uintmax_t(1181), boost::uintmax_t(1) << 40,
+                                 std::numeric_limits<boost::uintmax_t>::max() / 3 }){
+        engine_type engine_discard(42);
+        engine_discard.discard(pos);
+        BOOST_CHECK_EQUAL(engine_origin.value_at(pos), engine_discard());
+        BOOST_CHECK_EQUAL(engine_origin.value_at(pos + 1), engine_discard());
+    }
+
+    // block_at is the keyed block of a counter
+    typename engine_type::ctr_type ctr;
+    ctr.fill(3);
+    BOOST_CHECK(engine_origin.block_at(ctr) == engine_origin(ctr));
+}
+
+
+
+template<typename Mapper, typename Engine>
+void check_mapper_fill(Engine engine){
+    typedef typename Mapper::result_type result_type;
+
+    Engine engine_ref(engine);
+    Mapper mapper(engine);
+
+    // mix single values and blocks, starting and ending inside the buffer
+    for(std::size_t n : { std::size_t(1), std::size_t(3), std::size_t(40), std::size_t(0), std::size_t(17), std::size_t(1000) }){
+        BOOST_CHECK_EQUAL(mapper(), result_type(engine_ref()));
+
+        std::vector<result_type> values(n);
+        mapper.fill(values.data(), n);
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK_EQUAL(values[i], result_type(engine_ref()));
+        }
+    }
+
+    // a copy continues with the buffered values
+    Mapper mapper_copy(mapper);
+    for(std::size_t i = 0; i < 50; ++i){
+        const result_type v = mapper();
+        BOOST_CHECK_EQUAL(mapper_copy(), v);
+        BOOST_CHECK_EQUAL(v, result_type(engine_ref()));
+    }
+
+    // seeding drops the buffered values
+    mapper.seed(7);
+    engine_ref.seed(7);
+    for(std::size_t i = 0; i < 50; ++i){
+        BOOST_CHECK_EQUAL(mapper(), result_type(engine_ref()));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( mapper_block_generate)
+{
+    check_mapper_fill<hadoken::random_engine_mapper_32>(boost::random::mt11213b());
+    check_mapper_fill<hadoken::random_engine_mapper_32>(boost::random::taus88());
+    check_mapper_fill<hadoken::random_engine_mapper_64>(hadoken::counter_engine<hadoken::threefry4x64>(42));
+    check_mapper_fill<hadoken::random_engine_mapper_32>(hadoken::counter_engine<hadoken::philox4x32>(42));
+    // value type of the engine narrower than the mapper one
+    check_mapper_fill<hadoken::random_engine_mapper_64>(hadoken::counter_engine<hadoken::threefry4x32>(42));
+}
+
+
+
+template<typename Mapper>
+void check_mapper_storage(Mapper mapper, bool expected_inline){
+    typedef typename Mapper::result_type result_type;
+
+    BOOST_CHECK_EQUAL(mapper.inline_storage(), expected_inline);
+    (void) mapper();
+
+    Mapper reference(mapper);
+    BOOST_CHECK_EQUAL(reference.inline_storage(), expected_inline);
+
+    // move keeps the stream, and keeps the storage kind
+    Mapper moved(std::move(mapper));
+    BOOST_CHECK_EQUAL(moved.inline_storage(), expected_inline);
+    BOOST_CHECK(mapper.inline_storage() == false);
+
+    // copy and move assignments
+    Mapper assigned;
+    assigned = reference;
+    Mapper move_assigned(reference.derivate(1));
+    move_assigned = std::move(assigned);
+
+    for(std::size_t i = 0; i < 100; ++i){
+        const result_type v = reference();
+        BOOST_CHECK_EQUAL(moved(), v);
+        BOOST_CHECK_EQUAL(move_assigned(), v);
+    }
+
+    // derivation keeps the storage kind and is deterministic
+    Mapper derivated = reference.derivate(42), derivated_same = reference.derivate(42);
+    BOOST_CHECK_EQUAL(derivated.inline_storage(), expected_inline);
+    for(std::size_t i = 0; i < 100; ++i){
+        BOOST_CHECK_EQUAL(derivated(), derivated_same());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( mapper_inline_storage)
+{
+    // counter engines and small engines are stored in the mapper
+    check_mapper_storage(hadoken::random_engine_mapper_64(hadoken::counter_engine<hadoken::threefry4x64>(42)), true);
+    check_mapper_storage(hadoken::random_engine_mapper_32(hadoken::counter_engine<hadoken::ars4x32>(42)), true);
+    check_mapper_storage(hadoken::random_engine_mapper_32(boost::random::taus88()), true);
+
+    // mersenne twister is too big, stored on the heap
+    check_mapper_storage(hadoken::random_engine_mapper_32(boost::random::mt19937()), false);
+
+    // configurable inline size
+    typedef hadoken::random_engine_mapper<boost::uint64_t, 8> tiny_mapper;
+    check_mapper_storage(tiny_mapper(hadoken::counter_engine<hadoken::threefry4x64>(42)), false);
+}
+
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( engine_derivate_n, T, counter_engine_types )
+{
+    typedef hadoken::counter_engine<T> engine_type;
+    typedef typename engine_type::result_type result_type;
+
+    engine_type engine(1234);
+
+    std::vector<result_type> keys;
+    for(std::size_t i = 0; i < 37; ++i){
+        keys.push_back(result_type(i * 7 + 1));
+    }
+
+    // with and without buffered values in the parent engine
+    for(std::size_t step = 0; step < 3; ++step){
+        std::vector<engine_type> derivated;
+        hadoken::random_engine_derivate_n(engine, keys.begin(), keys.size(), std::back_inserter(derivated));
+        BOOST_REQUIRE_EQUAL(derivated.size(), keys.size());
+
+        for(std::size_t i = 0; i < keys.size(); ++i){
+            engine_type reference = engine.derivate(keys[i]);
+            BOOST_CHECK(derivated[i] == reference);
+            BOOST_CHECK_EQUAL(derivated[i](), reference());
+        }
+
+        // full keys
+        std::vector<typename engine_type::key_type> full_keys(3);
+        for(std::size_t i = 0; i < full_keys.size(); ++i){
+            full_keys[i].fill(typename engine_type::key_type::value_type(i + 100));
+        }
+        std::vector<engine_type> derivated_full(full_keys.size());
+        engine.derivate_n(full_keys.begin(), full_keys.size(), derivated_full.begin());
+        for(std::size_t i = 0; i < full_keys.size(); ++i){
+            BOOST_CHECK(derivated_full[i] == engine.derivate(full_keys[i]));
+        }
+
+        (void) engine();
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( engine_derivate_n_generic)
+{
+    boost::random::taus88 engine(42);
+
+    const boost::uint32_t keys[] = { 1, 2, 42, 1000 };
+    std::vector<boost::random::taus88> derivated;
+    hadoken::random_engine_derivate_n(engine, keys, 4, std::back_inserter(derivated));
+
+    for(std::size_t i = 0; i < 4; ++i){
+        BOOST_CHECK(derivated[i] == hadoken::random_engine_derivate(engine, keys[i]));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( uniform01_bits_conversion)
+{
+    using hadoken::impl::uniform01_from_bits;
+
+    BOOST_CHECK_EQUAL(uniform01_from_bits<double>(0), 0.0);
+    BOOST_CHECK_EQUAL(uniform01_from_bits<double>(std::numeric_limits<boost::uint64_t>::max()), 1.0 - std::ldexp(1.0, -52));
+    BOOST_CHECK_EQUAL(uniform01_from_bits<double>(UINT64_C(1) << 63), 0.5);
+
+    BOOST_CHECK_EQUAL(uniform01_from_bits<float>(0), 0.0f);
+    BOOST_CHECK_EQUAL(uniform01_from_bits<float>(std::numeric_limits<boost::uint32_t>::max()), 1.0f - std::ldexp(1.0f, -23));
+    BOOST_CHECK_EQUAL(uniform01_from_bits<float>(UINT32_C(1) << 31), 0.5f);
+}
+
+
+BOOST_AUTO_TEST_CASE( distributions_fast_math)
+{
+    using namespace hadoken::impl;
+
+    BOOST_CHECK_EQUAL(fast_log(1.0), 0.0);
+    BOOST_CHECK_EQUAL(fast_log(1.0f), 0.0f);
+
+    double max_log_error = 0, max_log_error_float = 0, max_sincos_error = 0;
+
+    boost::random::mt19937_64 rng(42);
+    for(std::size_t i = 0; i < 100000; ++i){
+        const boost::uint64_t w = rng();
+
+        // log over the whole range of 1 - u, down to the smallest values
+        const double x = std::ldexp(1.0 - uniform01_from_bits<double>(w), -int(i % 53));
+        max_log_error = std::max(max_log_error, std::abs(fast_log(x) - std::log(x)) / std::max(1.0, std::abs(std::log(x))));
+
+        const float xf = 1.0f - uniform01_from_bits<float>(static_cast<boost::uint32_t>(w));
+        max_log_error_float = std::max(max_log_error_float, double(std::abs(fast_log(xf) - std::log(xf))) / std::max(1.0, std::abs(std::log(double(xf)))));
+
+        double s, c;
+        sincos_from_bits<double>(w, s, c);
+        const double theta = 6.283185307179586476925286766559 * std::ldexp(double(w >> 10), -54);
+        max_sincos_error = std::max(max_sincos_error, std::max(std::abs(s - std::sin(theta)), std::abs(c - std::cos(theta))));
+    }
+
+    BOOST_CHECK_LT(max_log_error, 1e-15);
+    BOOST_CHECK_LT(max_log_error_float, 1e-6);
+    BOOST_CHECK_LT(max_sincos_error, 2e-15);
+}
+
+
+// bulk generation gives the same sequence than operator()
+template<typename Distribution, typename Engine>
+void check_distribution_generate(Distribution dist, Engine engine){
+    typedef typename Distribution::result_type value_type;
+
+    Distribution dist_ref(dist);
+    Engine engine_ref(engine);
+
+    for(std::size_t n : { std::size_t(1), std::size_t(2), std::size_t(7), std::size_t(0), std::size_t(1000), std::size_t(3) }){
+        std::vector<value_type> values(n);
+        dist.generate(engine, values.begin(), values.end());
+
+        for(std::size_t i = 0; i < n; ++i){
+            BOOST_CHECK_EQUAL(values[i], dist_ref(engine_ref));
+        }
+    }
+    BOOST_CHECK_EQUAL(dist(engine), dist_ref(engine_ref));
+}
+
+
+template<typename Distribution>
+void check_distribution_generate_engines(const Distribution & dist){
+    check_distribution_generate(dist, hadoken::counter_engine<hadoken::threefry4x64>(42));
+    check_distribution_generate(dist, hadoken::counter_engine<hadoken::philox4x32>(42));
+    check_distribution_generate(dist, hadoken::random_engine_mapper_32(boost::random::mt19937(42)));
+    check_distribution_generate(dist, boost::random::mt19937_64(42));
+}
+
+
+typedef boost::mpl::list<float, double> real_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( distributions_generate, Real, real_types )
+{
+    check_distribution_generate_engines(hadoken::uniform01<Real>());
+    check_distribution_generate_engines(hadoken::normal_distribution<Real>(3, 2));
+    check_distribution_generate_engines(hadoken::exponential_distribution<Real>(4));
+}
+
+
+template<typename Distribution>
+void distribution_moments(Distribution dist, std::size_t n, double & mean, double & variance){
+    hadoken::counter_engine<hadoken::threefry4x64> engine(1234);
+    std::vector<typename Distribution::result_type> values(n);
+    dist.generate(engine, values.begin(), values.end());
+
+    mean = 0;
+    for(std::size_t i = 0; i < n; ++i){
+        mean += values[i];
+    }
+    mean /= n;
+
+    variance = 0;
+    for(std::size_t i = 0; i < n; ++i){
+        variance += (values[i] - mean) * (values[i] - mean);
+    }
+    variance /= (n - 1);
+}
+
+
+BOOST_AUTO_TEST_CASE( distributions_moments)
+{
+    const std::size_t n = 1 << 20;
+    double mean, variance;
+
+    distribution_moments(hadoken::uniform01<double>(), n, mean, variance);
+    BOOST_CHECK_CLOSE(mean, 0.5, 0.5);
+    BOOST_CHECK_CLOSE(variance, 1.0 / 12, 1.0);
+
+    distribution_moments(hadoken::normal_distribution<double>(3, 2), n, mean, variance);
+    BOOST_CHECK_CLOSE(mean, 3.0, 0.5);
+    BOOST_CHECK_CLOSE(variance, 4.0, 1.0);
+
+    distribution_moments(hadoken::normal_distribution<float>(-1, 0.5f), n, mean, variance);
+    BOOST_CHECK_CLOSE(mean, -1.0, 0.5);
+    BOOST_CHECK_CLOSE(variance, 0.25, 1.0);
+
+    distribution_moments(hadoken::exponential_distribution<double>(4), n, mean, variance);
+    BOOST_CHECK_CLOSE(mean, 0.25, 0.5);
+    BOOST_CHECK_CLOSE(variance, 1.0 / 16, 1.0);
+}